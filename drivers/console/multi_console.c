@@ -108,26 +108,35 @@ int putchar(int c)
 		return EOF;
 }
 
-int console_getc(void)
+int console_try_getc(void)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
 
-	do {	/* Keep polling while at least one console works correctly. */
-		for (console = console_list; console != NULL;
-		     console = console->next)
-			if ((console->flags & console_state) && (console->getc != NULL)) {
-				int ret = console->getc(console);
-				if (ret >= 0)
-					return ret;
-				if (err != ERROR_NO_PENDING_CHAR)
-					err = ret;
-			}
-	} while (err == ERROR_NO_PENDING_CHAR);
+	for (console = console_list; console != NULL;
+	     console = console->next)
+		if ((console->flags & console_state) && (console->getc != NULL)) {
+			int ret = console->getc(console);
+			if (ret >= 0)
+				return ret;
+			if (err != ERROR_NO_PENDING_CHAR)
+				err = ret;
+		}
 
 	return err;
 }
 
+int console_getc(void)
+{
+	int ret;
+
+	do {	/* Keep polling while at least one console works correctly. */
+		ret = console_try_getc();
+	} while (ret == ERROR_NO_PENDING_CHAR);
+
+	return ret;
+}
+
 void console_flush(void)
 {
 	console_t *console;
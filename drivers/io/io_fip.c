@@ -25,6 +25,11 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/* Number of ToC entries cached per FIP device, 0 disables the index */
+#ifndef FIP_TOC_INDEX_ENTRIES
+#define FIP_TOC_INDEX_ENTRIES	0
+#endif
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -47,6 +52,13 @@ typedef struct {
 typedef struct {
 	uintptr_t dev_spec;
 	uint16_t plat_toc_flag;
+#if FIP_TOC_INDEX_ENTRIES > 0
+	/* ToC index, valid for the backend it was read from */
+	unsigned int toc_count;
+	uintptr_t toc_dev_handle;
+	uintptr_t toc_image_spec;
+	fip_toc_entry_t toc[FIP_TOC_INDEX_ENTRIES];
+#endif
 } fip_dev_state_t;
 
 /*
@@ -205,6 +217,10 @@ static int fip_dev_open(const uintptr_t dev_spec,
 	state = (fip_dev_state_t *)info->info;
 
 	state->dev_spec = dev_spec;
+#if FIP_TOC_INDEX_ENTRIES > 0
+	/* A fresh open starts without an index */
+	state->toc_count = 0U;
+#endif
 
 	*dev_info = info;
 
@@ -212,6 +228,60 @@ static int fip_dev_open(const uintptr_t dev_spec,
 }
 
 
+#if FIP_TOC_INDEX_ENTRIES > 0
+/*
+ * Read the ToC following the header into the device index, so files
+ * are looked up without going to the backend. If the ToC does not fit,
+ * the index is left empty and files are found by scanning the ToC.
+ */
+static void fip_toc_index_build(fip_dev_state_t *state, uintptr_t backend_handle)
+{
+	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
+	fip_toc_entry_t entry;
+	size_t bytes_read;
+	unsigned int count = 0U;
+
+	for (;;) {
+		if (io_read(backend_handle, (uintptr_t)&entry, sizeof(entry),
+			    &bytes_read) != 0 || bytes_read != sizeof(entry)) {
+			WARN("FIP ToC read failed, not indexed\n");
+			return;
+		}
+
+		if (compare_uuids(&entry.uuid, &uuid_null) == 0) {
+			break;
+		}
+
+		if (count == (unsigned int)FIP_TOC_INDEX_ENTRIES) {
+			WARN("FIP ToC exceeds %u entries, not indexed\n",
+			     (unsigned int)FIP_TOC_INDEX_ENTRIES);
+			return;
+		}
+
+		state->toc[count++] = entry;
+	}
+
+	VERBOSE("FIP ToC indexed, %u entries\n", count);
+	state->toc_count = count;
+	state->toc_dev_handle = backend_dev_handle;
+	state->toc_image_spec = backend_image_spec;
+}
+
+static const fip_toc_entry_t *fip_toc_index_find(const fip_dev_state_t *state,
+						 const uuid_t *uuid)
+{
+	unsigned int i;
+
+	for (i = 0U; i < state->toc_count; i++) {
+		if (compare_uuids(&state->toc[i].uuid, uuid) == 0) {
+			return &state->toc[i];
+		}
+	}
+
+	return NULL;
+}
+#endif
+
 /* Do some basic package checks. */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
@@ -236,6 +306,16 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		goto fip_dev_init_exit;
 	}
 
+#if FIP_TOC_INDEX_ENTRIES > 0
+	/* Nothing to do if the index of this FIP is at hand */
+	if (state->toc_count != 0U &&
+	    state->toc_dev_handle == backend_dev_handle &&
+	    state->toc_image_spec == backend_image_spec) {
+		return 0;
+	}
+	state->toc_count = 0U;
+#endif
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -258,6 +338,9 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			 * bits [32-47] in fip header.
 			 */
 			state->plat_toc_flag = (header.flags >> 32) & 0xffff;
+#if FIP_TOC_INDEX_ENTRIES > 0
+			fip_toc_index_build(state, backend_handle);
+#endif
 		}
 	}
 
@@ -290,6 +373,9 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
 	size_t bytes_read;
 	int found_file = 0;
+#if FIP_TOC_INDEX_ENTRIES > 0
+	const fip_dev_state_t *state;
+#endif
 
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
@@ -305,6 +391,24 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		return -ENFILE;
 	}
 
+#if FIP_TOC_INDEX_ENTRIES > 0
+	state = (fip_dev_state_t *)dev_info->info;
+	if (state->toc_count != 0U) {
+		const fip_toc_entry_t *entry =
+			fip_toc_index_find(state, &uuid_spec->uuid);
+
+		if (entry == NULL) {
+			return -ENOENT;
+		}
+
+		current_fip_file.entry = *entry;
+		current_fip_file.file_pos = 0;
+		entity->info = (uintptr_t)&current_fip_file;
+
+		return 0;
+	}
+#endif
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -479,3 +583,39 @@ int fip_dev_get_plat_toc_flag(io_dev_info_t *dev_info, uint16_t *plat_toc_flag)
 
 	return 0;
 }
+
+/* Look up a file in the ToC index of a FIP device */
+int fip_dev_get_toc_entry(io_dev_info_t *dev_info, const uuid_t *uuid,
+			  fip_toc_entry_t *entry)
+{
+#if FIP_TOC_INDEX_ENTRIES > 0
+	const fip_toc_entry_t *found;
+
+	assert(dev_info != NULL);
+	assert(uuid != NULL);
+	assert(entry != NULL);
+
+	found = fip_toc_index_find((fip_dev_state_t *)dev_info->info, uuid);
+	if (found == NULL) {
+		return -ENOENT;
+	}
+
+	*entry = *found;
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+/* Drop the ToC indexes, to be used when the backing FIP changes */
+void fip_dev_invalidate_toc_index(void)
+{
+#if FIP_TOC_INDEX_ENTRIES > 0
+	unsigned int index;
+
+	for (index = 0; index < (unsigned int)MAX_FIP_DEVICES; ++index) {
+		state_pool[index].toc_count = 0U;
+	}
+#endif
+}
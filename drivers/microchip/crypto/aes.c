@@ -17,6 +17,7 @@
 
 #include "platform_def.h"
 #include "lan966x_regs.h"
+#include "lan966x_wait.h"
 
 #define AES_KEYLEN_128	0
 #define AES_KEYLEN_192	1
@@ -69,10 +70,10 @@ static void unaligned_put32(void *p, uint32_t w)
 #define MAX_TIMEOUT_US	(1000U)	/* 1ms */
 static uint32_t aes_wait_flag(uint32_t mask)
 {
-	uint64_t timeout;
+	struct lan966x_wait wait;
 	uint32_t s;
 
-	timeout = timeout_init_us(MAX_TIMEOUT_US);
+	lan966x_wait_init(&wait, MAX_TIMEOUT_US);
 	/* Wait for ISR status */
 	while (true) {
 		s = mmio_read_32(AES_AES_ISR(base));
@@ -82,7 +83,7 @@ static uint32_t aes_wait_flag(uint32_t mask)
 			s = mmio_read_32(AES_AES_WPSR(base));
 			WARN("WPSR: %08x\n", s);
 		}
-		if (timeout_elapsed(timeout)) {
+		if (lan966x_wait_timeout(&wait)) {
 			ERROR("AES: Timeout awaiting ISR flag %08x, have 0x%08x\n", mask, s);
 			plat_error_handler(-ETIMEDOUT);
 		}
@@ -330,3 +331,16 @@ int aes_gcm_encrypt(void *data_ptr, size_t len,
 
 	return rc;
 }
+
+int aes_gcm_encrypt_start(size_t data_len,
+			  const void *key, unsigned int key_len,
+			  const void *iv, unsigned int iv_len)
+{
+	return aes_setup(true, data_len, key, key_len, iv, iv_len);
+}
+
+int aes_gcm_encrypt_finish(void *tag, unsigned int tag_len)
+{
+	/* Get auth tag */
+	return aes_get_tag(tag, tag_len);
+}
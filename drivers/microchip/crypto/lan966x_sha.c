@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <boot_trace.h>
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/delay_timer.h>
@@ -16,6 +17,7 @@
 
 #include <platform_def.h>
 #include "lan966x_regs.h"
+#include "lan966x_wait.h"
 
 #define SHA_SHA_IDATAR(b, n)	(SHA_SHA_IDATAR0(b) + (n * 4))
 #define SHA_SHA_IODATAR(b, n)	(SHA_SHA_IODATAR0(b) + (n * 4))
@@ -76,10 +78,10 @@ void sha_init(void)
 #define MAX_TIMEOUT_US	(10000U)	/* 10ms */
 static uint32_t sha_wait_flag(uint32_t mask)
 {
-	uint64_t timeout;
+	struct lan966x_wait wait;
 	uint32_t s;
 
-	timeout = timeout_init_us(MAX_TIMEOUT_US);
+	lan966x_wait_init(&wait, MAX_TIMEOUT_US);
 	while (true) {
 		s = mmio_read_32(SHA_SHA_ISR(base));
 		if (s & SHA_SHA_ISR_SECE_ISR_M) {
@@ -88,7 +90,7 @@ static uint32_t sha_wait_flag(uint32_t mask)
 		}
 		if (mask & s)
 			break;
-		if (timeout_elapsed(timeout)) {
+		if (lan966x_wait_timeout(&wait)) {
 			ERROR("SHA: Timeout awaiting ISR flag %08x, have 0x%08x\n", mask, s);
 			plat_error_handler(-ETIMEDOUT);
 		}
@@ -244,10 +246,16 @@ int sha_calc(lan966x_sha_type_t hash_type, const void *input, size_t len, void *
 	}
 
 	struct hash_state *st = _sha_init(hash_type, len, NULL, hinfo->hash_len);
+	int ret;
+
+	boot_trace(BOOT_TRACE_SHA_START, len);
 
 	_sha_update(st, input, len);
+	ret = _sha_finish(st, hash);
+
+	boot_trace(BOOT_TRACE_SHA_DONE, 0);
 
-	return _sha_finish(st, hash);
+	return ret;
 }
 
 int sha_verify(lan966x_sha_type_t hash_type, const void *input, size_t len, const void *hash, size_t hash_len)
@@ -290,3 +298,14 @@ int sha_calc_finish(void *state, void *hash)
 {
 	return _sha_finish(state, hash);
 }
+
+void sha_abort(void *state)
+{
+	struct hash_state *st = state;
+
+	assert(st->inuse == true);
+
+	/* Discard partial hash */
+	st->inuse = false;
+	sha_init();
+}
@@ -17,6 +17,7 @@
 #include <tools_share/firmware_encrypted.h>
 
 #include "lan966x_regs.h"
+#include "lan966x_wait.h"
 #include "xdmac_priv.h"
 
 #if defined(LAN966X_XDMAC_BASE)
@@ -32,6 +33,16 @@ static uintptr_t base = LAN969X_XDMAC_BASE;
 
 #define MAX_CHANNEL	16U
 
+/* Linked list descriptor pool, for the low channels only */
+#define XDMAC_LLD_CHANNELS	4
+#define XDMAC_LLD_PER_CH	16U
+
+static struct xdmac_lld xdmac_lld_pool[XDMAC_LLD_CHANNELS][XDMAC_LLD_PER_CH]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+
+/* Channels set up for a linked list transfer */
+static uint32_t xdmac_ll_channels;
+
 static inline int xdmac_compute_cc(int dir, int periph)
 {
 	int cc = 0;
@@ -78,54 +89,76 @@ void xdmac_make_req(struct xdmac_req *req, int ch, int dir, int periph, uintptr_
 	req->len = len;
 }
 
-static uint32_t xdmac_setup_req(const struct xdmac_req *req)
+static uint32_t xdmac_compute_cfg(int dir, int periph, uintptr_t align, uint32_t *round)
 {
-	int ch = req->ch;
 	int csize = AT_XDMAC_CSIZE_16;
 	int dwidth;
-	uint32_t cfg, dma_len;
 
-	VERBOSE("%d: dir %d periph %d dst %08x src %08x len %d\n",
-		req->ch, req->dir, req->periph,
-		req->dst, req->src, req->len);
-
-	assert(req->len <= AT_XDMAC_MBR_UBC_UBLEN_MAX);
-
-	dma_len = req->len;
-	if (req->periph == XDMA_SHA_TX) {
+	*round = 1U;
+	if (periph == XDMA_SHA_TX) {
 		dwidth = AT_XDMAC_CC_DWIDTH_WORD;
 		/* Round up to whole words */
-		dma_len = round_up(dma_len, 4U);
-	} else if (req->periph == XDMA_AES_RX || req->periph == XDMA_AES_TX) {
+		*round = 4U;
+	} else if (periph == XDMA_AES_RX || periph == XDMA_AES_TX) {
 		dwidth = AT_XDMAC_CC_DWIDTH_WORD;
 		csize = AT_XDMAC_CSIZE_4; /* DS mandates this for CTR, GCM */
 		/* Round up to SHA256 block - 128bits/16bytes */
-		dma_len = round_up(dma_len, 16U);
+		*round = 16U;
 	} else {
-		dwidth = xdmac_align_width(req->src | req->dst);
-		if (!is_aligned(dma_len, 1 << dwidth))
-			dwidth = AT_XDMAC_CC_DWIDTH_BYTE;
+		/* Addresses and length must all match the data width */
+		dwidth = xdmac_align_width(align);
 	}
-	cfg = XDMAC_XDMAC_CC_CH0_DWIDTH_CH0(dwidth) |
+
+	return XDMAC_XDMAC_CC_CH0_DWIDTH_CH0(dwidth) |
 		XDMAC_XDMAC_CC_CH0_CSIZE_CH0(csize) |
-		xdmac_compute_cc(req->dir, req->periph);
+		xdmac_compute_cc(dir, periph);
+}
 
+static void xdmac_cache_prepare(int dir, uintptr_t dst, uintptr_t src, size_t len)
+{
 	/* Cache cleaning, XDMAC is *not* cache aware */
-	if (req->dir == XDMA_DIR_MEM_TO_DEV || req->dir == XDMA_DIR_MEM_TO_MEM) {
-		flush_dcache_range(req->src, dma_len);
+	if (dir == XDMA_DIR_MEM_TO_DEV || dir == XDMA_DIR_MEM_TO_MEM) {
+		flush_dcache_range(src, len);
 	}
-	if (req->dir == XDMA_DIR_DEV_TO_MEM || req->dir == XDMA_DIR_MEM_TO_MEM ||
-	    req->dir == XDMA_DIR_BZERO) {
-		inv_dcache_range(req->dst, dma_len);
+	if (dir == XDMA_DIR_DEV_TO_MEM || dir == XDMA_DIR_MEM_TO_MEM ||
+	    dir == XDMA_DIR_BZERO) {
+		inv_dcache_range(dst, len);
 	}
+}
 
+static void xdmac_channel_reset(int ch)
+{
 	/* Disable channel by Global Channel Disable Register */
 	mmio_write_32(XDMAC_XDMAC_GD(base), BIT(ch));
 
 	/* Clear pending irq(s) by reading channel status register */
 	(void) mmio_read_32(XDMAC_XDMAC_CIS_CH0(CH_OFF(base, ch)));
+}
+
+static uint32_t xdmac_setup_req(const struct xdmac_req *req)
+{
+	int ch = req->ch;
+	int dwidth;
+	uint32_t cfg, dma_len, round;
+
+	VERBOSE("%d: dir %d periph %d dst %08x src %08x len %d\n",
+		req->ch, req->dir, req->periph,
+		req->dst, req->src, req->len);
+
+	cfg = xdmac_compute_cfg(req->dir, req->periph,
+				req->src | req->dst | req->len, &round);
+	dwidth = XDMAC_XDMAC_CC_CH0_DWIDTH_CH0_X(cfg);
+	dma_len = round_up(req->len, round);
+
+	assert((dma_len >> dwidth) <= AT_XDMAC_MBR_UBC_UBLEN_MAX);
+
+	xdmac_cache_prepare(req->dir, req->dst, req->src, dma_len);
+
+	xdmac_channel_reset(ch);
+	xdmac_ll_channels &= ~BIT(ch);
 
 	/* Set up transfer registers */
+	mmio_write_32(XDMAC_XDMAC_CNDC_CH0(CH_OFF(base, ch)), 0); /* No descriptor fetch */
 	mmio_write_32(XDMAC_XDMAC_CDA_CH0(CH_OFF(base, ch)), req->dst);
 	mmio_write_32(XDMAC_XDMAC_CSA_CH0(CH_OFF(base, ch)), req->src);
 	mmio_write_32(XDMAC_XDMAC_CDS_MSP_CH0(CH_OFF(base, ch)), 0); /* Used for bzero */
@@ -135,19 +168,113 @@ static uint32_t xdmac_setup_req(const struct xdmac_req *req)
 	return BIT(ch);		/* Return channel mask to wait for */
 }
 
+/*
+ * Set up a linked list transfer of a scatter-gather list. Each list
+ * entry is split into as many microblocks as needed, and the
+ * controller fetches the descriptors itself - so the whole list
+ * completes as a single transfer.
+ */
+uint32_t xdmac_setup_sg(int ch, const struct xdmac_sg *sg, unsigned int nsg,
+			int dir, int periph)
+{
+	struct xdmac_lld *lld;
+	uintptr_t align = 0;
+	uint32_t cfg, round;
+	size_t max_len, len, off, chunk;
+	unsigned int i, n = 0;
+	int dwidth;
+
+	assert(ch < XDMAC_LLD_CHANNELS);
+	assert(nsg > 0U);
+
+	lld = xdmac_lld_pool[ch];
+
+	for (i = 0; i < nsg; i++)
+		align |= sg[i].dst | sg[i].src | sg[i].len;
+
+	cfg = xdmac_compute_cfg(dir, periph, align, &round);
+	dwidth = XDMAC_XDMAC_CC_CH0_DWIDTH_CH0_X(cfg);
+	/* Largest microblock, kept a multiple of any rounding */
+	max_len = round_down((size_t) AT_XDMAC_MBR_UBC_UBLEN_MAX << dwidth, 16U);
+
+	for (i = 0; i < nsg; i++) {
+		len = sg[i].len;
+		if (i == (nsg - 1U)) {
+			len = round_up(len, round);
+		} else {
+			/* Only the last entry may be padded */
+			assert(is_aligned(len, round));
+		}
+
+		VERBOSE("%d: sg %d: dir %d periph %d dst %08lx src %08lx len %zd\n",
+			ch, i, dir, periph, (unsigned long) sg[i].dst,
+			(unsigned long) sg[i].src, len);
+
+		xdmac_cache_prepare(dir, sg[i].dst, sg[i].src, len);
+
+		for (off = 0; off < len; off += chunk) {
+			chunk = MIN(max_len, len - off);
+
+			if (n == XDMAC_LLD_PER_CH) {
+				ERROR("XDMAC(%d): Out of descriptors\n", ch);
+				plat_error_handler(-ENOMEM);
+			}
+
+			/* Peripheral side address is fixed */
+			lld[n].mbr_sa = sg[i].src;
+			if (dir != XDMA_DIR_DEV_TO_MEM)
+				lld[n].mbr_sa += off;
+			lld[n].mbr_da = sg[i].dst;
+			if (dir != XDMA_DIR_MEM_TO_DEV)
+				lld[n].mbr_da += off;
+			lld[n].mbr_ubc = AT_XDMAC_MBR_UBC_NDV1 |
+				AT_XDMAC_MBR_UBC_NSEN | AT_XDMAC_MBR_UBC_NDEN |
+				(chunk >> dwidth);
+			lld[n].mbr_nda = 0;
+
+			/* Chain to previous */
+			if (n > 0) {
+				lld[n - 1].mbr_nda = (uintptr_t) &lld[n];
+				lld[n - 1].mbr_ubc |= AT_XDMAC_MBR_UBC_NDE;
+			}
+			n++;
+		}
+	}
+
+	/* Descriptors are fetched from memory */
+	flush_dcache_range((uintptr_t) lld, n * sizeof(*lld));
+
+	xdmac_channel_reset(ch);
+	xdmac_ll_channels |= BIT(ch);
+
+	/* First descriptor, microblock registers are loaded from it */
+	mmio_write_32(XDMAC_XDMAC_CNDA_CH0(CH_OFF(base, ch)),
+		      XDMAC_XDMAC_CNDA_CH0_NDA_CH0((uintptr_t) lld >> 2));
+	mmio_write_32(XDMAC_XDMAC_CNDC_CH0(CH_OFF(base, ch)),
+		      XDMAC_XDMAC_CNDC_CH0_NDVIEW_CH0(AT_XDMAC_CNDC_NDVIEW_NDV1) |
+		      XDMAC_XDMAC_CNDC_CH0_NDDUP_CH0(1) |
+		      XDMAC_XDMAC_CNDC_CH0_NDSUP_CH0(1) |
+		      XDMAC_XDMAC_CNDC_CH0_NDE_CH0(1));
+	mmio_write_32(XDMAC_XDMAC_CDS_MSP_CH0(CH_OFF(base, ch)), 0); /* Used for bzero */
+	mmio_write_32(XDMAC_XDMAC_CUBC_CH0(CH_OFF(base, ch)), 0);
+	mmio_write_32(XDMAC_XDMAC_CC_CH0(CH_OFF(base, ch)), cfg);
+
+	return BIT(ch);		/* Return channel mask to wait for */
+}
+
 static void xdmac_wait_idle(int ch)
 {
-	uint64_t timeout;
+	struct lan966x_wait wait;
 	uint32_t w;
 
 	/* Wait not busy */
-	timeout = timeout_init_us(MAX_TIMEOUT_US);
+	lan966x_wait_init(&wait, MAX_TIMEOUT_US);
 	while (true) {
 		w = mmio_read_32(XDMAC_XDMAC_GS(base));
 		VERBOSE("XDMAC: GS: %08x\n", w);
 		if ((w & BIT(ch)) == 0)
 			break;	/* Not busy, continue */
-		if (timeout_elapsed(timeout)) {
+		if (lan966x_wait_timeout(&wait)) {
 			ERROR("XDMAC(%d): Timeout awaiting GS_STX clear, 0x%08x\n", ch, w);
 			plat_error_handler(-ETIMEDOUT);
 		}
@@ -156,8 +283,8 @@ static void xdmac_wait_idle(int ch)
 	/* Check channel status */
 	w = mmio_read_32(XDMAC_XDMAC_CIS_CH0(CH_OFF(base, ch)));
 	VERBOSE("XDMAC: CIS(%d): %08x\n", ch, w);
-	if (w & AT_XDMAC_CIS_BIS)
-		return;	/* Block End Irq: We're done */
+	if (w & (AT_XDMAC_CIS_BIS | AT_XDMAC_CIS_LIS))
+		return;	/* Block/List End Irq: We're done */
 	if (w & AT_XDMAC_CIS_ERROR) {
 		ERROR("XDMAC(%d): Transfer error: %08x\n", ch, w);
 		plat_error_handler(-EIO);
@@ -171,10 +298,12 @@ static void xdmac_start(uint32_t channel_list)
 {
 	uint32_t w = channel_list;
 
-	/* Set Enable Block End Interrupt for channels */
+	/* Set Enable Block/List End Interrupt for channels */
 	while (w) {
 		int i = __builtin_ffs(w) - 1;
-		mmio_setbits_32(XDMAC_XDMAC_CIE_CH0(CH_OFF(base, i)), AT_XDMAC_CIE_BIE);
+		mmio_setbits_32(XDMAC_XDMAC_CIE_CH0(CH_OFF(base, i)),
+				(xdmac_ll_channels & BIT(i)) ?
+				AT_XDMAC_CIE_LIE : AT_XDMAC_CIE_BIE);
 		w &= ~BIT(i);
 	}
 
@@ -197,37 +326,36 @@ void xdmac_execute_xfers(uint32_t channel_list)
 	}
 }
 
-void xdmac_bzero(void *dst, size_t len)
+static void _xdmac_memcpy(int ch, void *dst, const void *src, size_t len, int dir, int periph)
 {
-	int ch = 0; /* Always use channel 0 */
+	uintptr_t src_va = (uintptr_t) src;
 	uintptr_t dst_va = (uintptr_t) dst;
-	struct xdmac_req req;
 
-	xdmac_make_req(&req, ch, XDMA_DIR_BZERO, XDMA_NONE, dst_va, 0, len);
-	xdmac_setup_req(&req);
+	if (len > AT_XDMAC_MBR_UBC_UBLEN_MAX) {
+		struct xdmac_sg sg = { .dst = dst_va, .src = src_va, .len = len };
+
+		/* Chain microblocks for the large ones */
+		xdmac_setup_sg(ch, &sg, 1, dir, periph);
+	} else {
+		struct xdmac_req req;
+		xdmac_make_req(&req, ch, dir, periph, dst_va, src_va, len);
+		xdmac_setup_req(&req);
+	}
 
 	/* Start and await the operation completion */
 	xdmac_execute_xfers(BIT(ch));
 }
 
-static void _xdmac_memcpy(int ch, void *dst, const void *src, size_t len, int dir, int periph)
+void xdmac_bzero(void *dst, size_t len)
 {
-	uintptr_t src_va = (uintptr_t) src;
-	uintptr_t dst_va = (uintptr_t) dst;
-
-	struct xdmac_req req;
-	xdmac_make_req(&req, ch, dir, periph, dst_va, src_va, len);
-	xdmac_setup_req(&req);
-
-	/* Start and await the operation completion */
-	xdmac_execute_xfers(BIT(ch));
+	_xdmac_memcpy(0, dst, NULL, len, XDMA_DIR_BZERO, XDMA_NONE);
 }
 
-void xdmac_setup_xfer(int ch, void *dst, const void *src, size_t len, int dir, int periph)
+uint32_t xdmac_setup_xfer(int ch, void *dst, const void *src, size_t len, int dir, int periph)
 {
 	struct xdmac_req req;
 	xdmac_make_req(&req, ch, dir, periph, (uintptr_t) dst, (uintptr_t) src, len);
-	xdmac_setup_req(&req);
+	return xdmac_setup_req(&req);
 }
 
 void xdmac_memcpy(void *dst, const void *src, size_t len, int dir, int periph)
@@ -235,6 +363,16 @@ void xdmac_memcpy(void *dst, const void *src, size_t len, int dir, int periph)
 	_xdmac_memcpy(0, dst, src, len, dir, periph);
 }
 
+void xdmac_memcpy_sg(const struct xdmac_sg *sg, unsigned int nsg, int dir, int periph)
+{
+	int ch = 0; /* Always use channel 0 */
+
+	xdmac_setup_sg(ch, sg, nsg, dir, periph);
+
+	/* Start and await the operation completion */
+	xdmac_execute_xfers(BIT(ch));
+}
+
 void xdmac_show_version(void)
 {
 	uint32_t w = mmio_read_32(XDMAC_XDMAC_VERSION(base));
@@ -243,7 +381,7 @@ void xdmac_show_version(void)
 	     (uint32_t) XDMAC_XDMAC_VERSION_MFN_X(w));
 }
 
-#if defined(XDMAC_PIPELINE_SUPPPORT) && defined(IMAGE_BL2)
+#if defined(XDMAC_PIPELINE_SUPPPORT) && (defined(IMAGE_BL2) || defined(IMAGE_BL2U))
 
 #define PDMA_BLOCK_SIZE	SIZE_K(16U)
 
@@ -261,15 +399,31 @@ static struct pipeline_state {
 	} decrypt;
 } xdma_pipeline;
 
+#if defined(IMAGE_BL2U)
+/* BL2U reuses its buffers, so only hash reads asked for - and only once */
+static bool pdma_sha_requested;
+
+void xdmac_qspi_sha_request(void)
+{
+	pdma_sha_requested = true;
+}
+#else
+void xdmac_qspi_sha_request(void)
+{
+}
+#endif
+
 static void _xdmac_qspi_pipeline_read(void *dst, const void *src, size_t len)
 {
 	struct pipeline_state *pdma = &xdma_pipeline;
-	struct xdmac_req dmas[4],
-		*mem = &dmas[0],
-		*dec_tx = &dmas[1],
-		*dec_rx = &dmas[2],
-		*sha = &dmas[3];
-	size_t read = 0, decrypted = 0, hashed = 0;
+	struct xdmac_pipeline pl = {
+		.dst = dst,
+		.src = src,
+		.len = len,
+		.block_size = PDMA_BLOCK_SIZE,
+	};
+	struct xdmac_stage *st = pl.stages;
+	int ret;
 
 	pdma->src = (uintptr_t) src;
 	pdma->dst = (uintptr_t) dst;
@@ -278,97 +432,48 @@ static void _xdmac_qspi_pipeline_read(void *dst, const void *src, size_t len)
 	 * since we are calculating this ahead of time. */
 	pdma->sha_type = SHA_MR_ALGO_SHA256;
 
-	/* Setup DMA chain */
-	xdmac_make_req(mem, 0, XDMA_DIR_MEM_TO_MEM, XDMA_NONE, pdma->dst, pdma->src, len);
-	xdmac_make_req(dec_tx, 1, XDMA_DIR_MEM_TO_DEV, XDMA_AES_TX, AES_AES_IDATAR0(LAN966X_AES_BASE), pdma->dst, len);
-	xdmac_make_req(dec_rx, 2, XDMA_DIR_DEV_TO_MEM, XDMA_AES_RX, pdma->dst, AES_AES_ODATAR0(LAN966X_AES_BASE), len);
-	xdmac_make_req(sha, 3, XDMA_DIR_MEM_TO_DEV, XDMA_SHA_TX, SHA_SHA_IDATAR0(LAN966X_SHA_BASE), pdma->dst, len);
-
-	void *sha_ctx = sha_calc_init(pdma->sha_type, len, sizeof(pdma->hash));
+	/* QSPI read to memory */
+	st->op = XDMAC_STAGE_COPY;
+	st++;
 
 	if (pdma->streaming_decrypt) {
-		aes_gcm_decrypt_start(len,
-				      pdma->decrypt.key, pdma->decrypt.key_len,
-				      pdma->decrypt.fw_hdr.iv, pdma->decrypt.fw_hdr.iv_len);
+		st->op = XDMAC_STAGE_AES;
+		st->aes.encrypt = false;
+		st->aes.key = pdma->decrypt.key;
+		st->aes.key_len = pdma->decrypt.key_len;
+		st->aes.iv = pdma->decrypt.fw_hdr.iv;
+		st->aes.iv_len = pdma->decrypt.fw_hdr.iv_len;
+		st->aes.tag = pdma->decrypt.fw_hdr.tag;
+		st->aes.tag_len = pdma->decrypt.fw_hdr.tag_len;
+		st++;
 	}
 
-	while (hashed < len) {
-		uint32_t channel_list = 0;
-
-		/* Need to read more data? */
-		if (read < len) {
-			mem->len = MIN((size_t) PDMA_BLOCK_SIZE, len - read);
-			/* Ready QSPI read to memory block transfer */
-			channel_list |= xdmac_setup_req(mem);
-			VERBOSE("QSPI read start: %d bytes, DST offset %08x\n", mem->len, mem->dst);
-		}
-
-		if (pdma->streaming_decrypt) {
-			/* Need to decrypt data? */
-			if (decrypted < read) {
-				uint32_t chunk = MIN((size_t) PDMA_BLOCK_SIZE, read - decrypted);
-				/* Ready tx/rx inplace decrypt */
-				dec_tx->len = chunk;
-				channel_list |= xdmac_setup_req(dec_tx);
-				dec_rx->len = chunk;
-				channel_list |= xdmac_setup_req(dec_rx);
-				VERBOSE("AES decrypt start: %d bytes, SRC offset %08x\n", dec_tx->len, dec_tx->src);
-			}
-		} else {
-			decrypted = read; /* Cleartext */
-		}
-
-		/* Need to hash data? */
-		if (hashed < decrypted) {
-			sha->len = MIN((size_t) PDMA_BLOCK_SIZE, decrypted - hashed);
-			/* Ready SHA update round */
-			channel_list |= xdmac_setup_req(sha);
-			VERBOSE("SHA hash start: %d bytes, SRC offset %08x\n", sha->len, sha->src);
-		}
-
-		assert(channel_list != 0); /* Inside loop we always have xfers to do */
+	st->op = XDMAC_STAGE_SHA;
+	st->sha.type = pdma->sha_type;
+	st->sha.hash = pdma->hash;
+	st->sha.hash_len = sizeof(pdma->hash);
+	st++;
 
-		VERBOSE("DMA start: mask %02x: read %zd, decrypted %zd, hashed %zd\n",
-			channel_list, read, decrypted, hashed);
+	pl.nstages = st - pl.stages;
 
-		xdmac_execute_xfers(channel_list);
+	ret = xdmac_pipeline_run(&pl);
+	if (ret != 0)
+		VERBOSE("QSPI pipeline read: %d\n", ret);
 
-		/* Update read state */
-		if (channel_list & BIT(mem->ch)) {
-			VERBOSE("QSPI read done: %d bytes, DST offset %08x\n", mem->len, mem->dst);
-			read += mem->len;
-			mem->dst += mem->len;
-			mem->src += mem->len;
-		}
-
-		/* Update SHA hash state */
-		if (channel_list & BIT(dec_tx->ch)) {
-			VERBOSE("AES decrypt done: %d bytes, SRC offset %08x\n", dec_tx->len, dec_tx->src);
-			decrypted += dec_tx->len;
-			dec_tx->src += dec_tx->len;
-			dec_rx->dst += dec_tx->len;
-		}
-
-		/* Update SHA hash state */
-		if (channel_list & BIT(sha->ch)) {
-			VERBOSE("SHA hash done: %d bytes, SRC offset %08x\n", sha->len, sha->src);
-			hashed += sha->len;
-			sha->src += sha->len;
-		}
-	}
-
-	if (pdma->streaming_decrypt) {
-		pdma->was_decrypted =
-			aes_gcm_decrypt_finish(pdma->decrypt.fw_hdr.tag, pdma->decrypt.fw_hdr.tag_len) == 0;
-	}
-
-	sha_calc_finish(sha_ctx, pdma->hash);
+	pdma->was_decrypted = pdma->streaming_decrypt && ret == 0;
 }
 
 void xdmac_qspi_pipeline_read(void *dst, const void *src, size_t len)
 {
 	struct pipeline_state *pdma = &xdma_pipeline;
-	if (len >= 2*PDMA_BLOCK_SIZE) {
+	bool pipeline = len >= 2*PDMA_BLOCK_SIZE;
+
+#if defined(IMAGE_BL2U)
+	pipeline = pipeline && pdma_sha_requested;
+	pdma_sha_requested = false;
+#endif
+
+	if (pipeline) {
 		_xdmac_qspi_pipeline_read(dst, src, len);
 	} else {
 		pdma->len = 0;	/* Invalid */
@@ -407,6 +512,9 @@ int xdmac_qspi_get_sha(const void *data, size_t len, int sha_type, void *hash, s
 	    pdma->dst == (uintptr_t) data &&
 	    sizeof(pdma->hash) <= hash_len) {
 		memcpy(hash, pdma->hash, sizeof(pdma->hash));
+#if defined(IMAGE_BL2U)
+		pdma->len = 0;	/* Used */
+#endif
 		return 0;
 	}
 
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include <common/debug.h>
+#include <drivers/microchip/aes.h>
+#include <drivers/microchip/sha.h>
+#include <drivers/microchip/xdmac.h>
+#include <lib/libc/errno.h>
+#include <lib/utils_def.h>
+#include <platform_def.h>
+
+#include "lan966x_regs.h"
+
+#define PIPELINE_BLOCK_SIZE	SIZE_K(16U)
+
+/* Per stage progress */
+struct stage_state {
+	int ch;			/* First DMA channel */
+	size_t done;		/* Bytes processed */
+	size_t chunk;		/* Bytes in flight */
+	void *sha_ctx;
+};
+
+static int xdmac_pipeline_check(const struct xdmac_pipeline *pl)
+{
+	uint32_t ops = 0;
+	unsigned int i;
+
+	if (pl->len == 0 ||
+	    pl->nstages == 0 || pl->nstages > XDMAC_PIPELINE_MAX_STAGES)
+		return -EINVAL;
+
+	/* Block size must keep AES blocks whole */
+	if (pl->block_size != 0 && (pl->block_size % 16U) != 0)
+		return -EINVAL;
+
+	for (i = 0; i < pl->nstages; i++) {
+		int op = pl->stages[i].op;
+
+		/* One of each, there is only a single AES and SHA engine */
+		if (op > XDMAC_STAGE_SHA || (ops & BIT(op)))
+			return -EINVAL;
+		/* Copy produces the data, so it must come first */
+		if (op == XDMAC_STAGE_COPY && i != 0)
+			return -EINVAL;
+		ops |= BIT(op);
+	}
+
+	return 0;
+}
+
+static int xdmac_stage_start(const struct xdmac_pipeline *pl,
+			     const struct xdmac_stage *st,
+			     struct stage_state *ss)
+{
+	switch (st->op) {
+	case XDMAC_STAGE_COPY:
+		return 0;
+
+	case XDMAC_STAGE_AES:
+		if (st->aes.encrypt)
+			return aes_gcm_encrypt_start(pl->len,
+						     st->aes.key, st->aes.key_len,
+						     st->aes.iv, st->aes.iv_len);
+		return aes_gcm_decrypt_start(pl->len,
+					     st->aes.key, st->aes.key_len,
+					     st->aes.iv, st->aes.iv_len);
+
+	case XDMAC_STAGE_SHA:
+		ss->sha_ctx = sha_calc_init(st->sha.type, pl->len, st->sha.hash_len);
+		return ss->sha_ctx == NULL ? -EINVAL : 0;
+	}
+
+	return -EINVAL;
+}
+
+static int xdmac_stage_finish(const struct xdmac_stage *st,
+			      struct stage_state *ss)
+{
+	switch (st->op) {
+	case XDMAC_STAGE_AES:
+		if (st->aes.encrypt)
+			return aes_gcm_encrypt_finish(st->aes.tag, st->aes.tag_len);
+		return aes_gcm_decrypt_finish(st->aes.tag, st->aes.tag_len);
+
+	case XDMAC_STAGE_SHA:
+		return sha_calc_finish(ss->sha_ctx, st->sha.hash);
+	}
+
+	return 0;
+}
+
+/* Ready the DMA transfer(s) of the next block of a stage */
+static uint32_t xdmac_stage_setup(const struct xdmac_pipeline *pl,
+				  const struct xdmac_stage *st,
+				  const struct stage_state *ss)
+{
+	uint8_t *dst = (uint8_t *) pl->dst + ss->done;
+	const uint8_t *src = (const uint8_t *) pl->src + ss->done;
+	uint32_t mask = 0;
+
+	switch (st->op) {
+	case XDMAC_STAGE_COPY:
+		mask |= xdmac_setup_xfer(ss->ch, dst, src, ss->chunk,
+					 XDMA_DIR_MEM_TO_MEM, XDMA_NONE);
+		break;
+
+	case XDMAC_STAGE_AES:
+		/* Tx/rx in place */
+		mask |= xdmac_setup_xfer(ss->ch,
+					 (void *) (uintptr_t) AES_AES_IDATAR0(LAN966X_AES_BASE),
+					 dst, ss->chunk,
+					 XDMA_DIR_MEM_TO_DEV, XDMA_AES_TX);
+		mask |= xdmac_setup_xfer(ss->ch + 1, dst,
+					 (const void *) (uintptr_t) AES_AES_ODATAR0(LAN966X_AES_BASE),
+					 ss->chunk,
+					 XDMA_DIR_DEV_TO_MEM, XDMA_AES_RX);
+		break;
+
+	case XDMAC_STAGE_SHA:
+		mask |= xdmac_setup_xfer(ss->ch,
+					 (void *) (uintptr_t) SHA_SHA_IDATAR0(LAN966X_SHA_BASE),
+					 dst, ss->chunk,
+					 XDMA_DIR_MEM_TO_DEV, XDMA_SHA_TX);
+		break;
+	}
+
+	return mask;
+}
+
+/*
+ * Run the pipeline stages over the data in blocks. Each stage works on
+ * data the previous stage has completed, so while one block is
+ * copied, the previous is decrypted and the one before that hashed -
+ * all at the same time.
+ */
+int xdmac_pipeline_run(struct xdmac_pipeline *pl)
+{
+	struct stage_state state[XDMAC_PIPELINE_MAX_STAGES] = { 0 };
+	size_t block = pl->block_size ? pl->block_size : PIPELINE_BLOCK_SIZE;
+	unsigned int i, last = pl->nstages - 1;
+	int ch = 0, ret, rc;
+
+	ret = xdmac_pipeline_check(pl);
+	if (ret != 0)
+		return ret;
+
+	for (i = 0; i < pl->nstages; i++) {
+		state[i].ch = ch;
+		ch += pl->stages[i].op == XDMAC_STAGE_AES ? 2 : 1;
+
+		ret = xdmac_stage_start(pl, &pl->stages[i], &state[i]);
+		if (ret != 0) {
+			/* Release hash engine if already claimed */
+			while (i-- > 0)
+				if (state[i].sha_ctx != NULL)
+					sha_abort(state[i].sha_ctx);
+			return ret;
+		}
+	}
+
+	while (state[last].done < pl->len) {
+		uint32_t channel_list = 0;
+
+		for (i = 0; i < pl->nstages; i++) {
+			/* First stage has all the data, others what's done before */
+			size_t avail = i == 0 ? pl->len : state[i - 1].done;
+
+			state[i].chunk = MIN(block, avail - state[i].done);
+			if (state[i].chunk)
+				channel_list |= xdmac_stage_setup(pl, &pl->stages[i],
+								  &state[i]);
+		}
+
+		assert(channel_list != 0); /* Inside loop we always have xfers to do */
+
+		VERBOSE("DMA pipeline start: mask %02x, done %zd\n",
+			channel_list, state[last].done);
+
+		xdmac_execute_xfers(channel_list);
+
+		for (i = 0; i < pl->nstages; i++)
+			state[i].done += state[i].chunk;
+	}
+
+	/* Finish all stages, report the first error */
+	for (i = 0; i < pl->nstages; i++) {
+		rc = xdmac_stage_finish(&pl->stages[i], &state[i]);
+		if (ret == 0)
+			ret = rc;
+	}
+
+	return ret;
+}
@@ -58,6 +58,20 @@
 #define AT_XDMAC_CIS_ERROR	GENMASK(7, 4) /* Error conditions 7-4 */
 
 #define AT_XDMAC_MBR_UBC_UBLEN_MAX      0xFFFFFFUL      /* Maximum Microblock Length */
+#define AT_XDMAC_MBR_UBC_NDE		BIT(24)	/* Next Descriptor Enable */
+#define AT_XDMAC_MBR_UBC_NSEN		BIT(25)	/* Next Descriptor Source Update */
+#define AT_XDMAC_MBR_UBC_NDEN		BIT(26)	/* Next Descriptor Destination Update */
+#define AT_XDMAC_MBR_UBC_NDV1		(0x1 << 27) /* Next Descriptor View 1 */
+
+#define AT_XDMAC_CNDC_NDVIEW_NDV1	0x1
+
+/* Linked list descriptor, view 1 */
+struct xdmac_lld {
+	uint32_t mbr_nda;	/* Next Descriptor Address */
+	uint32_t mbr_ubc;	/* Microblock Control */
+	uint32_t mbr_sa;	/* Source Address */
+	uint32_t mbr_da;	/* Destination Address */
+};
 
 #define AT_XDMAC_MAX_CHAN       16
 #define AT_XDMAC_MAX_CSIZE      16      /* 16 data */
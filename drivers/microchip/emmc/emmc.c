@@ -6,6 +6,7 @@
 
 #include <stddef.h>
 #include <assert.h>
+#include <errno.h>
 
 #include <drivers/delay_timer.h>
 #include <drivers/microchip/emmc.h>
@@ -13,12 +14,18 @@
 #include <drivers/mmc.h>
 
 #include "emmc_defs.h"
+#include "lan966x_wait.h"
 
 static card p_card;
 static uintptr_t reg_base;
 static uint16_t eistr = 0u;	/* Holds the error interrupt status */
 static lan966x_mmc_params_t lan966x_params;
 static bool use_dma;
+static bool use_adma;
+
+/* ADMA2 descriptors, each good for 64KiB. Larger transfers use SDMA */
+#define ADMA2_DESC_COUNT	128U
+static sdmmc_adma2_desc_t adma2_desc[ADMA2_DESC_COUNT] __aligned(CACHE_WRITEBACK_GRANULE);
 
 static const unsigned int TAAC_TimeExp[8] =
 	{ 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
@@ -26,6 +33,8 @@ static const unsigned int TAAC_TimeMant[16] =
 	{ 0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80 };
 
 #define EMMC_RESET_TIMEOUT_US		(1000 * 500) /* 500 ms */
+#define EMMC_TUNING_LOOPS		40
+#define EMMC_TUNING_TIMEOUT_US		(1000 * 150) /* 150 ms */
 
 #pragma weak plat_mmc_use_dma
 bool plat_mmc_use_dma(void)
@@ -246,6 +255,8 @@ static void lan966x_mmc_initialize(void)
 	VERBOSE("MMC: ATF CB init() \n");
 
 	use_dma = plat_mmc_use_dma();
+	use_adma = use_dma &&
+		(sdhci_read_32(reg_base, SDMMC_CA0R) & SDMMC_CA0R_ADMA2SUP);
 
 	retVal = lan966x_host_init();
 	if (retVal != 0) {
@@ -305,11 +316,14 @@ static void lan966x_get_csd_register(void)
 	}
 }
 
-static unsigned char lan966x_emmc_poll(unsigned int expected)
+static unsigned char lan966x_emmc_poll_timeout(unsigned int expected,
+					       uint32_t timeout_us)
 {
-	uint64_t timeout = timeout_init_us(EMMC_POLLING_TIMEOUT);
+	struct lan966x_wait wait;
 	uint16_t nistr = 0u;
 
+	lan966x_wait_init(&wait, timeout_us);
+
 	eistr = 0u;
 	do {
 		nistr = sdhci_read_16(reg_base, SDMMC_NISTR);
@@ -322,6 +336,10 @@ static unsigned char lan966x_emmc_poll(unsigned int expected)
 			ERROR(" NISTR: 0x%x \n", nistr);
 			ERROR(" NISTR expected: 0x%x \n", expected);
 			ERROR(" EISTR: 0x%x \n", eistr);
+			if (eistr & SDMMC_EISTR_ADMA)
+				ERROR(" AESR: 0x%x, ASAR0: 0x%x\n",
+				      sdhci_read_8(reg_base, SDMMC_AESR),
+				      sdhci_read_32(reg_base, SDMMC_ASAR0));
 
 			/* Clear Normal/Error Interrupt Status Register flags */
 			sdhci_write_16(reg_base, SDMMC_EISTR, eistr);
@@ -350,13 +368,26 @@ static unsigned char lan966x_emmc_poll(unsigned int expected)
 			return 0;
 		}
 
-	} while(!timeout_elapsed(timeout));
+	} while(!lan966x_wait_timeout(&wait));
 
 	ERROR("MMC: Timeout waiting for %08x - have %08x\n", expected, nistr);
 
 	return 1;
 }
 
+static unsigned char lan966x_emmc_poll(unsigned int expected)
+{
+	return lan966x_emmc_poll_timeout(expected, EMMC_POLLING_TIMEOUT);
+}
+
+/* Transfer complete may take a while for large transfers on slow media */
+static unsigned char lan966x_emmc_poll_xfer(size_t size)
+{
+	return lan966x_emmc_poll_timeout(SDMMC_NISTR_TRFC, EMMC_POLLING_TIMEOUT +
+					 (div_round_up(size, SIZE_M(1)) *
+					  EMMC_XFER_TIMEOUT_MIB));
+}
+
 static void lan966x_set_data_timeout(unsigned int trans_type)
 {
 	unsigned timeout_freq;
@@ -712,6 +743,44 @@ static int lan966x_recover_error(unsigned int error_int_status)
 	return 0;
 }
 
+/*
+ * Select the controller timing for the e.MMC bus mode: DDR52 and HS200
+ * map onto the DDR50 and SDR104 UHS modes. Plain HS keeps the legacy
+ * timing, as it always has.
+ */
+static void lan966x_mmc_set_timing(unsigned int clock, unsigned int width)
+{
+	uint16_t uhsms = SDMMC_HC2R_UHSMS_SDR12;
+
+	if (width == MMC_BUS_WIDTH_DDR_4 || width == MMC_BUS_WIDTH_DDR_8) {
+		uhsms = SDMMC_HC2R_UHSMS_DDR50;
+	} else if (clock > EMMC_HIGH_SPEED) {
+		uhsms = SDMMC_HC2R_UHSMS_SDR104;
+	}
+
+	/* Only offered with 1.8V I/O, see lan966x_mmc_init() */
+	assert(uhsms == SDMMC_HC2R_UHSMS_SDR12 || lan966x_params.io_1v8);
+
+	/* Timing must only change with SD clock stopped */
+	mmc_clrbits_16(reg_base, SDMMC_CCR, SDMMC_CCR_SDCLKEN);
+
+	if (uhsms != SDMMC_HC2R_UHSMS_SDR12) {
+		mmc_setbits_8(reg_base, SDMMC_HC1R, SDMMC_HC1R_HSEN);
+		/* UHS mode select only takes effect with 1.8V signaling */
+		if (!(sdhci_read_16(reg_base, SDMMC_HC2R) & SDMMC_HC2R_VS18EN)) {
+			mmc_setbits_16(reg_base, SDMMC_HC2R, SDMMC_HC2R_VS18EN);
+			/* Let the pad regulator settle */
+			mdelay(5);
+		}
+	} else {
+		mmc_clrsetbits_8(reg_base, SDMMC_HC1R, SDMMC_HC1R_HSEN, 0);
+		/* Tuning result only applies to HS200 */
+		mmc_clrbits_16(reg_base, SDMMC_HC2R, SDMMC_HC2R_SCLKSEL);
+	}
+
+	mmc_clrsetbits_16(reg_base, SDMMC_HC2R, SDMMC_HC2R_UHSMS_Msk, uhsms);
+}
+
 static int lan966x_mmc_set_ios(unsigned int clock, unsigned int width)
 {
 	static const char *width_codes[] = {"1 bit", "4 bits", "8 bits", "reserved3", "reserved4", "4 bits DDR", "8 bits DDR"};
@@ -740,11 +809,16 @@ static int lan966x_mmc_set_ios(unsigned int clock, unsigned int width)
 		return -1;
 	}
 
-	mmc_setbits_8(reg_base, SDMMC_HC1R, bus_width);
+	mmc_clrsetbits_8(reg_base, SDMMC_HC1R,
+			 SDMMC_HC1R_DW | SDMMC_HC1R_EXTDW, bus_width);
+
+	if (lan966x_params.mmc_dev_type == MMC_IS_EMMC) {
+		lan966x_mmc_set_timing(clock, width);
+	}
 
 	NOTICE("MMC: %d MHz, %s, %s\n",
 	       clock / 1000000U, width_codes[width],
-	       use_dma ? "SDMA" : "No DMA");
+	       use_adma ? "ADMA2" : use_dma ? "SDMA" : "No DMA");
 
 	if (lan966x_set_clk_freq(clock, SDMMC_CLK_CTRL_PROG_MODE)) {
 		return -1;
@@ -753,6 +827,39 @@ static int lan966x_mmc_set_ios(unsigned int clock, unsigned int width)
 	return 0;
 }
 
+/*
+ * Describe the buffer by an ADMA2 descriptor table, so the whole
+ * transfer runs without CPU intervention. Returns false if the buffer
+ * cannot be handled by ADMA2, and SDMA must be used.
+ */
+static bool lan966x_adma2_setup(uintptr_t buf, size_t size)
+{
+	size_t len;
+	int i;
+
+	/* 32-bit ADMA2 needs 32-bit, word aligned addresses */
+	if ((buf & 0x3U) != 0U || (uint64_t) buf + size > UINT32_MAX ||
+	    size > (ADMA2_DESC_COUNT * SDMMC_ADMA2_MAX_LEN))
+		return false;
+
+	for (i = 0; size > 0U; i++) {
+		len = MIN(size, (size_t) SDMMC_ADMA2_MAX_LEN);
+		adma2_desc[i].attr = SDMMC_ADMA2_ACT_TRAN | SDMMC_ADMA2_VALID;
+		adma2_desc[i].len = len & 0xFFFFU;	/* 64KiB encodes as 0 */
+		adma2_desc[i].addr = (uint32_t) buf;
+		buf += len;
+		size -= len;
+	}
+	adma2_desc[i - 1].attr |= SDMMC_ADMA2_END;
+
+	/* The controller fetches descriptors from memory */
+	flush_dcache_range((uintptr_t) adma2_desc, i * sizeof(adma2_desc[0]));
+
+	sdhci_write_32(reg_base, SDMMC_ASAR0, (uint32_t) (uintptr_t) adma2_desc);
+
+	return true;
+}
+
 static int lan966x_mmc_prepare(int lba, uintptr_t buf, size_t size, bool is_write)
 {
 	uint16_t mode = SDMMC_TMR_BCEN;
@@ -782,7 +889,14 @@ static int lan966x_mmc_prepare(int lba, uintptr_t buf, size_t size, bool is_writ
 
 	if (use_dma) {
 		mode |= SDMMC_TMR_DMAEN;
-		sdhci_write_32(reg_base, SDMMC_SSAR, buf);
+		if (use_adma && lan966x_adma2_setup(buf, size)) {
+			mmc_clrsetbits_8(reg_base, SDMMC_HC1R, SDMMC_HC1R_DMASEL_Msk,
+					 SDMMC_HC1R_DMASEL_ADMA32);
+		} else {
+			mmc_clrsetbits_8(reg_base, SDMMC_HC1R, SDMMC_HC1R_DMASEL_Msk,
+					 SDMMC_HC1R_DMASEL_SDMA);
+			sdhci_write_32(reg_base, SDMMC_SSAR, buf);
+		}
 		if (is_write) {
 			/* Flush cache -> memory */
 			flush_dcache_range(buf, size);
@@ -800,6 +914,8 @@ static int lan966x_mmc_prepare(int lba, uintptr_t buf, size_t size, bool is_writ
 
 static int lan966x_mmc_read(int lba, uintptr_t buf, size_t size)
 {
+	const size_t xfer_size = size;
+
 	VERBOSE("MMC: read - lba %08x, buf %08lx, size %zd\n", lba, buf, size);
 
 	if (!SD_CARD_STATUS_SUCCESS(sdhci_read_32(reg_base, SDMMC_RR0))) {
@@ -829,7 +945,7 @@ static int lan966x_mmc_read(int lba, uintptr_t buf, size_t size)
 
 	}
 
-	if (lan966x_emmc_poll(SDMMC_NISTR_TRFC)) {
+	if (lan966x_emmc_poll_xfer(xfer_size)) {
 		lan966x_recover_error(eistr);
 		return 1;
 	}
@@ -839,6 +955,8 @@ static int lan966x_mmc_read(int lba, uintptr_t buf, size_t size)
 
 static int lan966x_mmc_write(int lba, uintptr_t buf, size_t size)
 {
+	const size_t xfer_size = size;
+
 	VERBOSE("MMC: write - lba %08x, buf %08lx, size %zd\n", lba, buf, size);
 
 	/* Need to xfer by CPU? */
@@ -861,7 +979,7 @@ static int lan966x_mmc_write(int lba, uintptr_t buf, size_t size)
 		}
 	}
 
-	if (lan966x_emmc_poll(SDMMC_NISTR_TRFC)) {
+	if (lan966x_emmc_poll_xfer(xfer_size)) {
 		lan966x_recover_error(eistr);
 		return 1;
 	}
@@ -869,6 +987,81 @@ static int lan966x_mmc_write(int lba, uintptr_t buf, size_t size)
 	return 0;
 }
 
+static int lan966x_tuning_wait_lines(void)
+{
+	uint64_t timeout = timeout_init_us(EMMC_TUNING_TIMEOUT_US);
+
+	while (sdhci_read_32(reg_base, SDMMC_PSR) &
+	       (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD)) {
+		if (timeout_elapsed(timeout)) {
+			return -ETIMEDOUT;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * HS200 tuning: the controller moves its sampling point while CMD21
+ * fetches the tuning block, until it either finds a window (SCLKSEL
+ * set) or gives up (EXTUN cleared without SCLKSEL).
+ */
+static int lan966x_mmc_execute_tuning(unsigned int width)
+{
+	size_t blksize = (width == MMC_BUS_WIDTH_8) ? 128U : 64U;
+	uint64_t timeout;
+	uint16_t hc2r = 0;
+	int i;
+
+	VERBOSE("MMC: ATF CB execute_tuning() \n");
+
+	sdhci_write_16(reg_base, SDMMC_NISTER, ALL_FLAGS);
+	sdhci_write_16(reg_base, SDMMC_EISTER, ALL_FLAGS);
+
+	mmc_clrsetbits_16(reg_base, SDMMC_HC2R, SDMMC_HC2R_SCLKSEL, SDMMC_HC2R_EXTUN);
+
+	for (i = 0; i < EMMC_TUNING_LOOPS; i++) {
+		if (lan966x_tuning_wait_lines()) {
+			break;
+		}
+
+		sdhci_write_16(reg_base, SDMMC_NISTR, ALL_FLAGS);
+		sdhci_write_16(reg_base, SDMMC_EISTR, ALL_FLAGS);
+		sdhci_write_16(reg_base, SDMMC_BSR, SDMMC_BSR_BLKSIZE(blksize));
+		sdhci_write_16(reg_base, SDMMC_BCR, 1);
+		sdhci_write_16(reg_base, SDMMC_TMR, SDMMC_TMR_DTDSEL_READ);
+		sdhci_write_32(reg_base, SDMMC_ARG1R, 0);
+		sdhci_write_16(reg_base, SDMMC_CR, SDMMC_MMC_CMD21 & 0xFFFF);
+
+		/* Tuning block is consumed by the controller itself */
+		timeout = timeout_init_us(EMMC_TUNING_TIMEOUT_US);
+		while (!(sdhci_read_16(reg_base, SDMMC_NISTR) & SDMMC_NISTR_BRDRDY)) {
+			if (timeout_elapsed(timeout)) {
+				break;
+			}
+		}
+
+		hc2r = sdhci_read_16(reg_base, SDMMC_HC2R);
+		if (!(hc2r & SDMMC_HC2R_EXTUN)) {
+			break;
+		}
+	}
+
+	sdhci_write_16(reg_base, SDMMC_NISTR, ALL_FLAGS);
+	sdhci_write_16(reg_base, SDMMC_EISTR, ALL_FLAGS);
+
+	if (!(hc2r & SDMMC_HC2R_EXTUN) && (hc2r & SDMMC_HC2R_SCLKSEL)) {
+		VERBOSE("MMC: Tuning done after %d blocks\n", i + 1);
+		return 0;
+	}
+
+	/* Back to the fixed sampling clock */
+	mmc_clrbits_16(reg_base, SDMMC_HC2R, SDMMC_HC2R_EXTUN | SDMMC_HC2R_SCLKSEL);
+	lan966x_mmc_reset(SDMMC_SW_RST_DATA_CMD_LINES);
+
+	return -EIO;
+}
+
 /* Hold the callback information. Map ATF calls to user application code  */
 static const struct mmc_ops lan966x_ops = {
 	.init = lan966x_mmc_initialize,
@@ -877,11 +1070,13 @@ static const struct mmc_ops lan966x_ops = {
 	.prepare = lan966x_mmc_prepare,
 	.read = lan966x_mmc_read,
 	.write = lan966x_mmc_write,
+	.execute_tuning = lan966x_mmc_execute_tuning,
 };
 
 void lan966x_mmc_init(lan966x_mmc_params_t * params, struct mmc_device_info *info)
 {
 	int retVal, max_speed;
+	uint32_t caps;
 
 	VERBOSE("MMC: lan966x_mmc_init() \n");
 
@@ -902,12 +1097,32 @@ void lan966x_mmc_init(lan966x_mmc_params_t * params, struct mmc_device_info *inf
 
 	if ((params->bus_width != MMC_BUS_WIDTH_1) &&
 	    (params->bus_width != MMC_BUS_WIDTH_4) &&
-	    (params->bus_width != MMC_BUS_WIDTH_8)) {
+	    (params->bus_width != MMC_BUS_WIDTH_8) &&
+	    (params->bus_width != MMC_BUS_WIDTH_DDR_4) &&
+	    (params->bus_width != MMC_BUS_WIDTH_DDR_8)) {
 		WARN("MMC: Bus width %d not valid - using %d\n",
 		     params->bus_width, MMC_BUS_WIDTH_1);
 		params->bus_width = MMC_BUS_WIDTH_1;
 	}
 
+	/*
+	 * Only ask for the e.MMC bus modes the controller can do. Both
+	 * HS200 and DDR52 use the UHS timings, which need 1.8V I/O.
+	 */
+	caps = sdhci_read_32(params->reg_base, SDMMC_CA1R);
+	if (params->clk_rate > EMMC_HIGH_SPEED &&
+	    (!(caps & SDMMC_CA1R_SDR104SUP) || !params->io_1v8)) {
+		WARN("MMC: HS200 not supported - using %d\n", EMMC_HIGH_SPEED);
+		params->clk_rate = EMMC_HIGH_SPEED;
+	}
+	if ((params->bus_width == MMC_BUS_WIDTH_DDR_4 ||
+	     params->bus_width == MMC_BUS_WIDTH_DDR_8) &&
+	    (!(caps & SDMMC_CA1R_DDR50SUP) || !params->io_1v8)) {
+		WARN("MMC: DDR not supported - using SDR\n");
+		params->bus_width = (params->bus_width == MMC_BUS_WIDTH_DDR_8) ?
+			MMC_BUS_WIDTH_8 : MMC_BUS_WIDTH_4;
+	}
+
 	memcpy(&lan966x_params, params, sizeof(lan966x_mmc_params_t));
 	lan966x_params.mmc_dev_type = info->mmc_dev_type;
 	reg_base = lan966x_params.reg_base;
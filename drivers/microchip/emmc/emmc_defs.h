@@ -14,6 +14,7 @@
 #define SDMMC_CLK_CTRL_PROG_MODE	1
 
 #define EMMC_POLLING_TIMEOUT	2000000u	/* 2sec */
+#define EMMC_XFER_TIMEOUT_MIB	1000000u	/* 1sec per MiB, on top */
 #define EMMC_POLLING_VALUE	10000u
 
 #define ALL_FLAGS	(0xFFFFu) /* All Irq's */
@@ -123,6 +124,10 @@
 #define   SDMMC_HC1R_DW (0x1u << 1)	/* Data Width */
 #define   SDMMC_HC1R_DW_1_BIT (0x0u << 1)	/* 1-bit mode. */
 #define   SDMMC_HC1R_DW_4_BIT (0x1u << 1)	/* 4-bit mode. */
+#define   SDMMC_HC1R_HSEN (0x1u << 2)	/* High Speed Enable */
+#define   SDMMC_HC1R_DMASEL_Msk (0x3u << 3)	/* DMA Select */
+#define   SDMMC_HC1R_DMASEL_SDMA (0x0u << 3)	/* SDMA is selected */
+#define   SDMMC_HC1R_DMASEL_ADMA32 (0x2u << 3)	/* 32-bit Address ADMA2 is selected */
 #define   SDMMC_HC1R_EXTDW (0x1u << 5)	/* Extended Data Width */
 /* -------- SDMMC_PCR : (SDMMC Offset: 0x29) Power Control Register -------- */
 #define SDMMC_PCR	0x29	/* uint8_t */
@@ -161,6 +166,7 @@
 #define SDMMC_EISTR	0x32	/* uint16_t */
 #define   SDMMC_EISTR_CMDTEO (0x1u << 0)	/* Command Timeout Error */
 #define   SDMMC_EISTR_DATTEO (0x1u << 4)	/* Data Timeout Error */
+#define   SDMMC_EISTR_ADMA (0x1u << 9)	/* ADMA Error */
 /* -------- SDMMC_NISTER : (SDMMC Offset: 0x34) Normal Interrupt Status Enable Register -------- */
 #define SDMMC_NISTER	0x34	/* uint16_t */
 #define   SDMMC_NISTER_CMDC (0x1u << 0)	/* Command Complete Status Enable */
@@ -180,6 +186,15 @@
 #define   SDMMC_EISIER_DATTEO (0x1u << 4)	/* Data Timeout Error Signal Enable */
 #define   SDMMC_EISIER_DATCRC (0x1u << 5)	/* Data CRC Error Signal Enable */
 #define   SDMMC_EISIER_DATEND (0x1u << 6)	/* Data End Bit Error Signal Enable */
+/* -------- SDMMC_HC2R : (SDMMC Offset: 0x3E) Host Control 2 Register ------ */
+#define SDMMC_HC2R	0x3E	/* uint16_t */
+#define   SDMMC_HC2R_UHSMS_Msk (0x7u << 0)	/* UHS Mode Select */
+#define   SDMMC_HC2R_UHSMS_SDR12 (0x0u << 0)	/* Default/legacy timing */
+#define   SDMMC_HC2R_UHSMS_SDR104 (0x3u << 0)	/* SDR104, used for e.MMC HS200 */
+#define   SDMMC_HC2R_UHSMS_DDR50 (0x4u << 0)	/* DDR50, used for e.MMC DDR52 */
+#define   SDMMC_HC2R_VS18EN (0x1u << 3)	/* 1.8V Signaling Enable */
+#define   SDMMC_HC2R_EXTUN (0x1u << 6)	/* Execute Tuning */
+#define   SDMMC_HC2R_SCLKSEL (0x1u << 7)	/* Sampling Clock Select */
 /* -------- SDMMC_CA0R : (SDMMC Offset: 0x40) Capabilities 0 Register ------ */
 #define SDMMC_CA0R	0x40	/* uint32_t */
 #define   SDMMC_CA0R_TEOCLKF_Pos 0
@@ -188,7 +203,18 @@
 #define   SDMMC_CA0R_BASECLKF_Pos 8
 #define   SDMMC_CA0R_BASECLKF_Msk (0xffu << SDMMC_CA0R_BASECLKF_Pos)	/* Base Clock Frequency */
 #define   SDMMC_CA0R_ED8SUP (0x1u << 18)	/* 8-Bit Support for Embedded Device */
+#define   SDMMC_CA0R_ADMA2SUP (0x1u << 19)	/* ADMA2 Support */
 #define   SDMMC_CA0R_HSSUP (0x1u << 21)	/* High Speed Support */
+/* -------- SDMMC_CA1R : (SDMMC Offset: 0x44) Capabilities 1 Register ------ */
+#define SDMMC_CA1R	0x44	/* uint32_t */
+#define   SDMMC_CA1R_SDR104SUP (0x1u << 1)	/* SDR104 Support */
+#define   SDMMC_CA1R_DDR50SUP (0x1u << 2)	/* DDR50 Support */
+/* -------- SDMMC_AESR : (SDMMC Offset: 0x54) ADMA Error Status Register -- */
+#define SDMMC_AESR	0x54	/* uint8_t */
+#define   SDMMC_AESR_ERRST_Msk (0x3u << 0)	/* ADMA Error State */
+#define   SDMMC_AESR_LMIS (0x1u << 2)	/* ADMA Length Mismatch Error */
+/* -------- SDMMC_ASAR0 : (SDMMC Offset: 0x58) ADMA System Address Register 0 -- */
+#define SDMMC_ASAR0	0x58	/* uint32_t */
 /* -------- SDMMC_MC1R : (SDMMC Offset: 0x204) e.MMC Control 1 Register ---- */
 #define SDMMC_MC1R	0x204	/* uint8_t */
 #define   SDMMC_MC1R_CMDTYP_Pos 0
@@ -202,6 +228,19 @@
 #define SDMMC_DEBR_CDDVAL_Msk (0x3u << SDMMC_DEBR_CDDVAL_Pos)	/*(SDMMC_DEBR) Card Detect Debounce Value */
 #define SDMMC_DEBR_CDDVAL(value) ((SDMMC_DEBR_CDDVAL_Msk & ((value) << SDMMC_DEBR_CDDVAL_Pos)))
 
+/* ADMA2 descriptor (32-bit addressing) */
+typedef struct {
+	uint16_t attr;
+	uint16_t len;		/* 0 means 64KiB */
+	uint32_t addr;
+} sdmmc_adma2_desc_t;
+
+#define SDMMC_ADMA2_VALID	(0x1u << 0)
+#define SDMMC_ADMA2_END		(0x1u << 1)
+#define SDMMC_ADMA2_INT		(0x1u << 2)
+#define SDMMC_ADMA2_ACT_TRAN	(0x2u << 4)
+#define SDMMC_ADMA2_MAX_LEN	0x10000u
+
 /****************************************************************************************/
 /*      SD Card Commands Definitions                                                    */
 /****************************************************************************************/
@@ -255,6 +294,8 @@
 
 #define SDMMC_MMC_CMD20		(SDMMC_CR_CMDIDX(20) | SDMMC_CR_CMDTYP_NORMAL | SDMMC_CR_CMDICEN | SDMMC_CR_CMDCCEN | SDMMC_CR_RESPTYP_RL48 | SDMMC_CR_DPSEL | (SDMMC_MC1R_CMDTYP_STREAM << 16))
 
+#define SDMMC_MMC_CMD21		(SDMMC_CR_CMDIDX(21) | SDMMC_CR_CMDTYP_NORMAL | SDMMC_CR_CMDICEN | SDMMC_CR_CMDCCEN | SDMMC_CR_RESPTYP_RL48 | SDMMC_CR_DPSEL | (SDMMC_MC1R_CMDTYP_NORMAL << 16))
+
 #define SDMMC_MMC_CMD23		(SDMMC_CR_CMDIDX(23) | SDMMC_CR_CMDTYP_NORMAL | SDMMC_CR_CMDICEN | SDMMC_CR_CMDCCEN | SDMMC_CR_RESPTYP_RL48 | (SDMMC_MC1R_CMDTYP_NORMAL << 16))
 
 #define SDMMC_SD_CMD24		(SDMMC_CR_CMDIDX(24) | SDMMC_CR_CMDTYP_NORMAL | SDMMC_CR_CMDICEN | SDMMC_CR_CMDCCEN | SDMMC_CR_RESPTYP_RL48 | SDMMC_CR_DPSEL)
@@ -368,8 +409,16 @@ static const char *mmc_reg(int reg)
 		return "NISTER";
 	case SDMMC_EISTER:
 		return "EISTER";
+	case SDMMC_HC2R:
+		return "HC2R";
 	case SDMMC_CA0R:
 		return "CA0R";
+	case SDMMC_CA1R:
+		return "CA1R";
+	case SDMMC_AESR:
+		return "AESR";
+	case SDMMC_ASAR0:
+		return "ASAR0";
 	case SDMMC_MC1R:
 		return "MC1R";
 	case SDMMC_DEBR:
@@ -428,9 +477,19 @@ static inline void mmc_clrbits_16(uintptr_t addr, int reg, uint16_t clear)
 	sdhci_write_16(addr, reg, sdhci_read_16(addr, reg) & ~clear);
 }
 
+static inline void mmc_clrsetbits_16(uintptr_t addr, int reg, uint16_t clear, uint16_t set)
+{
+	sdhci_write_16(addr, reg, (sdhci_read_16(addr, reg) & ~clear) | set);
+}
+
 static inline void mmc_setbits_8(uintptr_t addr, int reg, uint8_t set)
 {
 	sdhci_write_8(addr, reg, sdhci_read_8(addr, reg) | set);
 }
 
+static inline void mmc_clrsetbits_8(uintptr_t addr, int reg, uint8_t clear, uint8_t set)
+{
+	sdhci_write_8(addr, reg, (sdhci_read_8(addr, reg) & ~clear) | set);
+}
+
 #endif	/* EMMC_DEFS_H */
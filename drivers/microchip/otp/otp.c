@@ -29,6 +29,9 @@ static uint32_t otp_flags;
 #endif /* defined(MCHP_OTP_EMULATION) */
 
 static uintptr_t reg_base = LAN966X_OTP_BASE;
+static unsigned int otp_write_gen;
+static unsigned int otp_power_refs;
+static int otp_addr_hi = -1;
 
 static bool otp_hw_wait_flag_clear(uintptr_t reg, uint32_t flag)
 {
@@ -78,6 +81,25 @@ static void otp_hw_power(bool up)
 	}
 }
 
+/*
+ * Powering up waits for the charge pump and the macro load, which
+ * dominates short reads. Nested users share a single power cycle.
+ */
+static void otp_hw_power_get(void)
+{
+	if (otp_power_refs++ == 0) {
+		otp_hw_power(true);
+		otp_addr_hi = -1;
+	}
+}
+
+static void otp_hw_power_put(void)
+{
+	assert(otp_power_refs > 0);
+	if (--otp_power_refs == 0)
+		otp_hw_power(false);
+}
+
 static int otp_hw_execute(void)
 {
 	if (!otp_hw_wait_flag_clear(OTP_OTP_CMD_GO(reg_base), OTP_OTP_CMD_GO_OTP_GO(1))) {
@@ -93,8 +115,14 @@ static int otp_hw_execute(void)
 
 static void otp_hw_set_address(unsigned int offset)
 {
+	int hi = 0xff & (offset >> 8);
+
 	assert(offset < OTP_MEM_SIZE);
-	mmio_write_32(OTP_OTP_ADDR_HI(reg_base), 0xff & (offset >> 8));
+	/* Sequential accesses mostly stay within the same 256 byte page */
+	if (hi != otp_addr_hi) {
+		mmio_write_32(OTP_OTP_ADDR_HI(reg_base), hi);
+		otp_addr_hi = hi;
+	}
 	mmio_write_32(OTP_OTP_ADDR_LO(reg_base), 0xff & offset);
 }
 
@@ -118,19 +146,23 @@ static int otp_hw_read_byte(unsigned int offset, uint8_t *dst)
 	return rc;
 }
 
+/*
+ * The controller only has an 8-bit read data register and no address
+ * auto-increment, so a burst is a byte loop within one power cycle.
+ */
 static int otp_hw_read_bytes(unsigned int offset, unsigned int nbytes, uint8_t *dst)
 {
 	uint8_t data;
 	int i, rc = 0;
 
-	otp_hw_power(true);
+	otp_hw_power_get();
 	for (i = 0; i < nbytes; i++) {
 		rc = otp_hw_read_byte(offset + i, &data);
 		if (rc < 0)
 			break;
 		*dst++ = data;
 	}
-	otp_hw_power(false);
+	otp_hw_power_put();
 
 	return rc;
 }
@@ -161,7 +193,7 @@ static int otp_hw_write_bytes(unsigned int offset, unsigned int nbytes, const ui
 	uint8_t data, newdata;
 	int i, rc = 0;
 
-	otp_hw_power(true);
+	otp_hw_power_get();
 	for (i = 0; i < nbytes; i++) {
 		/* Skip zero bytes */
 		if (src[i]) {
@@ -177,7 +209,7 @@ static int otp_hw_write_bytes(unsigned int offset, unsigned int nbytes, const ui
 			}
 		}
 	}
-	otp_hw_power(false);
+	otp_hw_power_put();
 
 	return rc;
 }
@@ -251,6 +283,9 @@ int otp_write_bytes(unsigned int offset, unsigned int nbytes, const uint8_t *dst
 	assert(nbytes > 0);
 	assert((offset + nbytes) < OTP_MEM_SIZE);
 
+	/* Stale caches of OTP data */
+	otp_write_gen++;
+
 	return otp_hw_write_bytes(offset, nbytes, dst);
 }
 
@@ -282,7 +317,8 @@ int otp_commit_emulation(void)
 	int rc = -ENODEV, i;
 
 	if (otp_flags & OTP_FLAG_EMULATION) {
-		otp_hw_power(true);
+		otp_write_gen++;
+		otp_hw_power_get();
 		for (i = 0; i < OTP_MEM_SIZE; i++) {
 			uint8_t eb = 0, ob, nb;
 			eb = otp_emu_get_byte(i);
@@ -301,7 +337,7 @@ int otp_commit_emulation(void)
 			}
 			eb = ob = nb = 0; /* Don't leak */
 		}
-		otp_hw_power(false);
+		otp_hw_power_put();
 	}
 
 	return rc;
@@ -314,6 +350,26 @@ int otp_read_bytes_raw(unsigned int offset, unsigned int nbytes, uint8_t *dst)
 	return otp_hw_read_bytes(offset, nbytes, dst);
 }
 
+/*
+ * Keep the OTP powered across a sequence of reads, such as scanning
+ * the tag area. Must be balanced by otp_read_end().
+ */
+void otp_read_begin(void)
+{
+	otp_hw_power_get();
+}
+
+void otp_read_end(void)
+{
+	otp_hw_power_put();
+}
+
+/* Changes whenever OTP is written, for caches of its contents */
+unsigned int otp_write_generation(void)
+{
+	return otp_write_gen;
+}
+
 int otp_write_regions(void)
 {
 	struct {
@@ -5,10 +5,13 @@
  */
 
 #include <errno.h>
+#include <stddef.h>
 #include <string.h>
+#include <arch_helpers.h>
 #include <lib/utils_def.h>
 #include <common/debug.h>
 
+#include <lan966x_crc32.h>
 #include <otp.h>
 #include <otp_tags.h>
 
@@ -118,13 +121,172 @@ int otp_tag_skip_cont(uint8_t *tag, int offset)
 	return offset;
 }
 
-int otp_tag_get(enum otp_tag_type tag, void *buf, size_t buf_size)
+static struct otp_tag_cache tag_cache __aligned(CACHE_WRITEBACK_GRANULE);
+static unsigned int tag_cache_gen;	/* otp_write_generation() at build */
+
+static uint32_t otp_tag_cache_crc(const struct otp_tag_cache *c)
+{
+	return Crc32c(0, c, offsetof(struct otp_tag_cache, crc));
+}
+
+static bool otp_tag_cache_valid(void)
+{
+	return tag_cache.magic == OTP_TAG_CACHE_MAGIC &&
+		tag_cache_gen == otp_write_generation();
+}
+
+/* Index the tag area and copy out the payloads, in one pass */
+static int otp_tag_cache_scan(struct otp_tag_cache *c)
 {
 	uint8_t tag_raw[OTP_TAG_ENTRY_LENGTH];
+	struct otp_tag_index *e;
+	size_t size;
 	int i, ret;
 
-	if (tag == otp_tag_type_invalid)
-		return -EINVAL;
+	c->count = 0;
+	c->used = 0;
+	c->complete = 1;
+
+	for (i = OTP_TAG_OFFSET; i < OTP_MAX_SIZE; i += OTP_TAG_ENTRY_LENGTH) {
+		ret = otp_read_bytes_raw(i, sizeof(tag_raw), tag_raw);
+		if (ret)
+			return ret;
+
+		/* Exit at first empty tag */
+		if (otp_tag_empty(tag_raw))
+			break;
+
+		/* Skip deleted tags */
+		if (!otp_tag_valid(tag_raw))
+			continue;
+
+		if (c->count == OTP_TAG_CACHE_ENTRIES) {
+			c->complete = 0;
+			break;
+		}
+
+		e = &c->idx[c->count];
+		e->tag = OTP_TAG_GET_TAG(tag_raw);
+		e->off = c->used;
+		e->len = 0;
+
+		/* Payload, including 'cont' records */
+		while (true) {
+			size = OTP_TAG_GET_SIZE(tag_raw);
+			if (c->used + size > OTP_TAG_CACHE_DATA) {
+				c->complete = 0;
+				return 0;
+			}
+			memcpy(&c->data[c->used], tag_raw, size);
+			c->used += size;
+			e->len += size;
+
+			if (!OTP_TAG_GET_CONT(tag_raw))
+				break;
+
+			/* Next tag */
+			i += OTP_TAG_ENTRY_LENGTH;
+
+			/* Incomplete? */
+			if (i >= OTP_MAX_SIZE)
+				return -EBADF;
+
+			/* We should get consecutive tags */
+			ret = otp_read_bytes_raw(i, sizeof(tag_raw), tag_raw);
+			if (ret || !otp_tag_valid(tag_raw))
+				return -EIO;
+		}
+
+		c->count++;
+	}
+
+	return 0;
+}
+
+static bool otp_tag_cache_build(void)
+{
+	int ret;
+
+	if (otp_tag_cache_valid())
+		return true;
+
+	tag_cache.magic = 0;
+	otp_read_begin();
+	ret = otp_tag_cache_scan(&tag_cache);
+	otp_read_end();
+	if (ret != 0)
+		return false;
+
+	tag_cache.magic = OTP_TAG_CACHE_MAGIC;
+	tag_cache.crc = otp_tag_cache_crc(&tag_cache);
+	tag_cache_gen = otp_write_generation();
+
+	VERBOSE("OTP: %d tags cached, %d bytes\n", tag_cache.count, tag_cache.used);
+
+	return true;
+}
+
+/* Address of the tag cache to pass on to the next stage */
+uintptr_t otp_tag_handoff(void)
+{
+	if (!otp_tag_cache_build())
+		return 0;
+
+	/* Passed between contexts */
+	flush_dcache_range((uintptr_t) &tag_cache, sizeof(tag_cache));
+
+	return (uintptr_t) &tag_cache;
+}
+
+/*
+ * Take over the tag cache of the previous stage, if it is within the
+ * memory of that stage and intact.
+ */
+void otp_tag_inherit(uintptr_t prev, uintptr_t base, uintptr_t limit)
+{
+	const struct otp_tag_cache *src = (const struct otp_tag_cache *) prev;
+
+	if (prev == 0U || (prev % sizeof(uint32_t)) != 0U ||
+	    prev < base || limit < sizeof(*src) || prev > (limit - sizeof(*src)))
+		return;
+
+	if (src->magic != OTP_TAG_CACHE_MAGIC ||
+	    src->crc != otp_tag_cache_crc(src) ||
+	    src->count > OTP_TAG_CACHE_ENTRIES ||
+	    src->used > OTP_TAG_CACHE_DATA)
+		return;
+
+	memcpy(&tag_cache, src, sizeof(tag_cache));
+	tag_cache_gen = otp_write_generation();
+	VERBOSE("OTP: %d tags inherited\n", tag_cache.count);
+}
+
+static int otp_tag_cache_get(enum otp_tag_type tag, void *buf, size_t buf_size)
+{
+	const struct otp_tag_index *e;
+	size_t i, len;
+
+	for (i = 0; i < tag_cache.count; i++) {
+		e = &tag_cache.idx[i];
+		if (e->tag != tag)
+			continue;
+
+		/* Its valid to read truncated len */
+		len = MIN((size_t) e->len, buf_size);
+		memset(buf, 0, buf_size);
+		memcpy(buf, &tag_cache.data[e->off], len);
+
+		return len;
+	}
+
+	return tag_cache.complete ? -ENOENT : -EAGAIN;
+}
+
+/* Linear walk of the tag area */
+static int otp_tag_find(enum otp_tag_type tag, void *buf, size_t buf_size)
+{
+	uint8_t tag_raw[OTP_TAG_ENTRY_LENGTH];
+	int i, ret;
 
 	for (i = OTP_TAG_OFFSET; i < OTP_MAX_SIZE; i += OTP_TAG_ENTRY_LENGTH) {
 		ret = otp_read_bytes_raw(i, sizeof(tag_raw), tag_raw);
@@ -149,3 +311,24 @@ int otp_tag_get(enum otp_tag_type tag, void *buf, size_t buf_size)
 
 	return -ENOENT;
 }
+
+int otp_tag_get(enum otp_tag_type tag, void *buf, size_t buf_size)
+{
+	int ret;
+
+	if (tag == otp_tag_type_invalid)
+		return -EINVAL;
+
+	if (otp_tag_cache_build()) {
+		ret = otp_tag_cache_get(tag, buf, buf_size);
+		if (ret != -EAGAIN)
+			return ret;
+	}
+
+	/* Not (all) cached, walk the OTP */
+	otp_read_begin();
+	ret = otp_tag_find(tag, buf, buf_size);
+	otp_read_end();
+
+	return ret;
+}
@@ -18,8 +18,10 @@
 
 #include "lan966x_def.h"
 #include "lan966x_regs.h"
+#include "lan966x_wait.h"
 
 #define SPI_READY_TIMEOUT_US	40000U
+#define SPI_BLOCK_ERASE_TIMEOUT_US	2000000U
 
 #define ERASE_BLOCK_SIZE	(4 * 1024U)
 #define WRITE_BLOCK_SIZE	256U
@@ -30,6 +32,8 @@ static bool qspi_init_done;
 
 static struct spi_mem_op default_read_op;
 
+static struct spi_nor_erase_type erase_types[SPI_NOR_MAX_ERASE_TYPES];
+
 #define SST_ID			0xBFU
 
 /* QSPI register offsets */
@@ -207,9 +211,7 @@ static struct spi_mem_op default_read_op;
 
 /* Non-std Command codes */
 #define SPI_NOR_OP_BE_4K_PMC	 0xd7	 /* Erase 4KiB block on PMC chips */
-#define SPI_NOR_OP_BE_32K	 0x52	 /* Erase 32KiB block */
 #define SPI_NOR_OP_CHIP_ERASE	 0xc7	 /* Erase whole flash chip */
-#define SPI_NOR_OP_SE		 0xd8	 /* Sector erase (usually 64KiB) */
 
 /* SPI_MEM utility functions */
 static void qspi_set_op(struct spi_mem_op *op, uint8_t cmd, enum spi_mem_data_dir dir)
@@ -242,14 +244,15 @@ static bool qspi_wait_flag(const uintptr_t reg,
 			   const uint32_t value,
 			   const char *fname)
 {
-	uint64_t timeout = timeout_init_us(QSPI_TIMEOUT);
+	struct lan966x_wait wait;
 	uint32_t w;
 
+	lan966x_wait_init(&wait, QSPI_TIMEOUT);
 	do {
 		w = mmio_read_32(reg);
 		if ((w & flag) == value)
 			return false;
-	} while (!timeout_elapsed(timeout));
+	} while (!lan966x_wait_timeout(&wait));
 
 	ERROR("QSPI: Timeout waiting for %s %s (%08x, %08x)\n", fname,
 	      value ? "set" : "clear", w, flag);
@@ -724,10 +727,10 @@ static int spi_nor_ready(void)
 	return (((sr & SR_WIP) != 0U) ? 1 : 0);
 }
 
-static int spi_nor_wait_ready(void)
+static int spi_nor_wait_ready_us(uint32_t timeout_us)
 {
 	int ret;
-	uint64_t timeout = timeout_init_us(SPI_READY_TIMEOUT_US);
+	uint64_t timeout = timeout_init_us(timeout_us);
 
 	while (!timeout_elapsed(timeout)) {
 		ret = spi_nor_ready();
@@ -739,6 +742,11 @@ static int spi_nor_wait_ready(void)
 	return -ETIMEDOUT;
 }
 
+static int spi_nor_wait_ready(void)
+{
+	return spi_nor_wait_ready_us(SPI_READY_TIMEOUT_US);
+}
+
 static int spi_nor_global_unlock(void)
 {
 	int ret;
@@ -777,12 +785,24 @@ int qspi_write_disable(void)
 	return qspi_exec_op(&op);
 }
 
-static int qspi_erase_sector(uint32_t addr)
+static int qspi_read_sfdp(uint32_t addr, void *buf, size_t len)
+{
+	struct spi_mem_op op;
+
+	qspi_set_op_data(&op, SPI_NOR_OP_READ_SFDP, SPI_MEM_DATA_IN, buf, len);
+	op.addr.val = addr;
+	op.dummy.buswidth = 1;
+	op.dummy.nbytes = 1;
+
+	return qspi_exec_op(&op);
+}
+
+static int qspi_erase_op(uint8_t cmd, uint32_t size, uint32_t addr)
 {
 	uint8_t buf[3];
 	int i, ret;
 
-	VERBOSE("qspi: Erase 4k @ %08x\n", addr);
+	VERBOSE("qspi: Erase %dk @ %08x\n", size / 1024, addr);
 
 	ret = qspi_write_enable();
 	if (ret)
@@ -794,22 +814,49 @@ static int qspi_erase_sector(uint32_t addr)
 		addr >>= 8;
 	}
 
-	return spi_nor_reg(SPI_NOR_OP_BE_4K, buf, sizeof(buf), SPI_MEM_DATA_OUT);
+	return spi_nor_reg(cmd, buf, sizeof(buf), SPI_MEM_DATA_OUT);
 }
 
-int qspi_erase(uint32_t offset, size_t len)
+static int qspi_erase_sector(uint32_t addr)
 {
-	uint32_t addr;
+	return qspi_erase_op(SPI_NOR_OP_BE_4K, ERASE_BLOCK_SIZE, addr);
+}
+
+int qspi_erase_block_start(uint32_t offset, size_t len)
+{
+	const struct spi_nor_erase_type *type;
 	int ret;
 
 	if (offset & (ERASE_BLOCK_SIZE-1))
 		return -EINVAL;
 
-	for (addr = offset; addr < (offset + len); addr += ERASE_BLOCK_SIZE) {
-		ret = qspi_erase_sector(addr);
-		if (ret)
+	/* Discover the available erase sizes on first use */
+	if (erase_types[0].size == 0U)
+		spi_nor_erase_types_init(erase_types, qspi_read_sfdp,
+					 ERASE_BLOCK_SIZE, SPI_NOR_OP_BE_4K);
+
+	type = spi_nor_erase_select(erase_types, offset, len);
+	ret = qspi_erase_op(type->opcode, type->size, offset);
+	if (ret)
+		return ret;
+
+	return (int) type->size;
+}
+
+int qspi_erase(uint32_t offset, size_t len)
+{
+	uint32_t addr;
+	int ret = 0, size;
+
+	for (addr = offset; addr < (offset + len); addr += size) {
+		size = qspi_erase_block_start(addr, offset + len - addr);
+		if (size < 0) {
+			ret = size;
 			break;
-		ret = spi_nor_wait_ready();
+		}
+		ret = spi_nor_wait_ready_us((uint32_t) size > ERASE_BLOCK_SIZE ?
+					    SPI_BLOCK_ERASE_TIMEOUT_US :
+					    SPI_READY_TIMEOUT_US);
 		if (ret)
 			break;
 	}
@@ -819,20 +866,31 @@ int qspi_erase(uint32_t offset, size_t len)
 	return ret;
 }
 
-int qspi_write_data_page(uint32_t offset, const void *buf, size_t len)
+int qspi_program_start(uint32_t offset, const void *buf, size_t len)
 {
 	struct spi_mem_op op;
 	int ret;
 
+	/* Must not cross a page boundary */
+	if ((offset & (WRITE_BLOCK_SIZE-1)) + len > WRITE_BLOCK_SIZE)
+		return -EINVAL;
+
 	/* Write enable */
 	ret = qspi_write_enable();
 	if (ret)
-		goto fail;
+		return ret;
 
 	/* Now write */
 	qspi_set_op_data(&op, SPI_NOR_OP_PP, SPI_MEM_DATA_OUT, (void *) buf, len);
 	op.addr.val = offset;
-	ret = qspi_exec_op(&op);
+	return qspi_exec_op(&op);
+}
+
+int qspi_write_data_page(uint32_t offset, const void *buf, size_t len)
+{
+	int ret;
+
+	ret = qspi_program_start(offset, buf, len);
 	if (ret)
 		goto fail;
 
@@ -874,10 +932,25 @@ int qspi_write_data(uint32_t offset, const void *buf, size_t len)
 	return ret;
 }
 
-int qspi_write(uint32_t offset, const void *buf, size_t len)
+static void qspi_restore_read(void)
 {
 	uint32_t ifr, iar;
-	int ret, ret1;
+	int ret;
+
+	/* Reset for memory read support */
+	ret = lan966x_qspi_set_cfg(&default_read_op, &ifr, &iar);
+	if (ret) {
+		ERROR("lan966x_qspi_set_cfg() error: %d", ret);
+		panic();
+	}
+
+	/* Write instruction frame */
+	qspi_change_ifr(ifr);
+}
+
+int qspi_write_begin(void)
+{
+	int ret;
 	uint8_t id;
 
 	ret = spi_nor_read_id(&id);
@@ -894,6 +967,37 @@ int qspi_write(uint32_t offset, const void *buf, size_t len)
 		}
 	}
 
+	return 0;
+}
+
+int qspi_erase_start(uint32_t offset)
+{
+	if (offset & (ERASE_BLOCK_SIZE-1))
+		return -EINVAL;
+
+	return qspi_erase_sector(offset);
+}
+
+int qspi_busy(void)
+{
+	return spi_nor_ready();
+}
+
+void qspi_write_end(void)
+{
+	(void) qspi_write_disable();
+
+	qspi_restore_read();
+}
+
+int qspi_write(uint32_t offset, const void *buf, size_t len)
+{
+	int ret;
+
+	ret = qspi_write_begin();
+	if (ret != 0)
+		return ret;
+
 	/* Erase area */
 	ret = qspi_erase(offset, len);
 	if (ret == 0) {
@@ -901,15 +1005,7 @@ int qspi_write(uint32_t offset, const void *buf, size_t len)
 		ret = qspi_write_data(offset, buf, len);
 	}
 
-	/* Reset for memory read support */
-	ret1 = lan966x_qspi_set_cfg(&default_read_op, &ifr, &iar);
-	if (ret1) {
-		ERROR("lan966x_qspi_set_cfg() error: %d", ret1);
-		panic();
-	}
-
-	/* Write instruction frame */
-	qspi_change_ifr(ifr);
+	qspi_restore_read();
 
 	return ret;
 }
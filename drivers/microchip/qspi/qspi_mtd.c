@@ -25,6 +25,8 @@
 #include <lib/utils.h>
 #include <platform_def.h>
 
+#include "lan966x_wait.h"
+
 #define MHZ	1000000U
 #define MHZ_NS	(1000U * MHZ)
 
@@ -202,9 +204,7 @@
 
 /* Non-std Command codes */
 #define SPI_NOR_OP_BE_4K_PMC	 0xd7	 /* Erase 4KiB block on PMC chips */
-#define SPI_NOR_OP_BE_32K	 0x52	 /* Erase 32KiB block */
 #define SPI_NOR_OP_CHIP_ERASE	 0xc7	 /* Erase whole flash chip */
-#define SPI_NOR_OP_SE		 0xd8	 /* Sector erase (usually 64KiB) */
 
 #define DT_QSPI_COMPAT	"microchip,lan966x-qspi"
 
@@ -255,14 +255,15 @@ static bool mchp_qspi_wait_flag(const unsigned int reg,
 			   const uint32_t value,
 			   const char *fname)
 {
-	uint64_t timeout = timeout_init_us(QSPI_TIMEOUT);
+	struct lan966x_wait wait;
 	uint32_t w;
 
+	lan966x_wait_init(&wait, QSPI_TIMEOUT);
 	do {
 		w = mchp_qspi_read(reg);
 		if ((w & flag) == value)
 			return false;
-	} while (!timeout_elapsed(timeout));
+	} while (!lan966x_wait_timeout(&wait));
 
 	ERROR("QSPI: Timeout waiting for %s %s (%08x, %08x)\n", fname,
 	      value ? "set" : "clear", w, flag);
@@ -781,6 +782,37 @@ int qspi_read(unsigned int offset, uintptr_t buffer, size_t length,
 	return spi_nor_read(offset, buffer, length, length_read);
 }
 
+int qspi_write_begin(void)
+{
+	/* Device unlock is handled by spi_nor_init() */
+	return 0;
+}
+
+int qspi_erase_start(uint32_t offset)
+{
+	return spi_nor_erase_start(offset);
+}
+
+int qspi_erase_block_start(uint32_t offset, size_t len)
+{
+	return spi_nor_erase_block_start(offset, len);
+}
+
+int qspi_program_start(uint32_t offset, const void *buf, size_t len)
+{
+	return spi_nor_write_page_start(offset, (uintptr_t) buf, len);
+}
+
+int qspi_busy(void)
+{
+	return spi_nor_busy();
+}
+
+void qspi_write_end(void)
+{
+	spi_nor_write_end();
+}
+
 int qspi_init(void)
 {
 	int qspi_node;
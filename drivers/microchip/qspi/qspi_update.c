@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <drivers/delay_timer.h>
+#include <drivers/microchip/qspi.h>
+#include <lib/utils_def.h>
+#include <platform_def.h>
+
+#define QSPI_UPDATE_TIMEOUT_US	1000000U
+#define QSPI_ERASE_TIMEOUT_US	2000000U	/* Up to 64KiB block erase */
+
+/* Current sector contents, read back by DMA */
+static uint8_t sector_buf[QSPI_SECTOR_SIZE] __aligned(CACHE_WRITEBACK_GRANULE);
+
+static bool qspi_is_blank(const uint8_t *data, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		if (data[i] != 0xFFU)
+			return false;
+
+	return true;
+}
+
+static int qspi_update_wait(uint32_t timeout_us)
+{
+	uint64_t timeout = timeout_init_us(timeout_us);
+	int ret;
+
+	while ((ret = qspi_busy()) != 0) {
+		if (ret < 0)
+			return ret;
+		if (timeout_elapsed(timeout))
+			return -ETIMEDOUT;
+	}
+
+	return 0;
+}
+
+/* Erase a run of sectors, with the largest erase blocks that fit */
+static int qspi_update_erase(uint32_t addr, size_t len)
+{
+	int ret;
+
+	while (len > 0) {
+		ret = qspi_erase_block_start(addr, len);
+		if (ret < 0)
+			return ret;
+
+		VERBOSE("qspi: Erased %dk @ %08x\n", ret / 1024, addr);
+		addr += ret;
+		len -= MIN((size_t) ret, len);
+
+		ret = qspi_update_wait(QSPI_ERASE_TIMEOUT_US);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int qspi_update_program(uint32_t addr, const uint8_t *data, size_t len)
+{
+	uint32_t off;
+	int ret;
+
+	for (off = 0; off < len; off += QSPI_PAGE_SIZE) {
+		size_t block = MIN((size_t) QSPI_PAGE_SIZE, len - off);
+
+		/* Erased flash already reads as 0xFF */
+		if (qspi_is_blank(data + off, block))
+			continue;
+
+		ret = qspi_program_start(addr + off, data + off, block);
+		if (ret == 0)
+			ret = qspi_update_wait(QSPI_UPDATE_TIMEOUT_US);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* Write 'len' bytes at 'addr', erasing the sectors covering them first if asked */
+static int qspi_update_write(uint32_t addr, const uint8_t *data, size_t len,
+			     bool erase, bool *unlocked)
+{
+	int ret;
+
+	if (!*unlocked) {
+		ret = qspi_write_begin();
+		if (ret != 0)
+			return ret;
+		*unlocked = true;
+	}
+
+	ret = 0;
+	if (erase)
+		ret = qspi_update_erase(addr, round_up(len, QSPI_SECTOR_SIZE));
+	if (ret == 0)
+		ret = qspi_update_program(addr, data, len);
+
+	/* Back to read mode for the next compare */
+	qspi_write_end();
+
+	return ret;
+}
+
+int qspi_update(uint32_t offset, const void *buf, size_t len,
+		struct qspi_update_stats *stats)
+{
+	struct qspi_update_stats st = { 0 };
+	const uint8_t *data = buf;
+	bool unlocked = false;
+	size_t done, chunk, act_read, run = 0;
+	bool blank;
+	int ret = 0;
+
+	if (offset & (QSPI_SECTOR_SIZE - 1))
+		return -EINVAL;
+
+	/*
+	 * Changed sectors are gathered into runs [done - run, done), which
+	 * are erased together when the run ends, so larger erase blocks
+	 * can be used.
+	 */
+	for (done = 0; done < len; done += chunk) {
+		chunk = MIN((size_t) QSPI_SECTOR_SIZE, len - done);
+
+		ret = qspi_read(offset + done, (uintptr_t) sector_buf, chunk, &act_read);
+		if (ret == 0 && act_read != chunk)
+			ret = -EIO;
+		if (ret != 0)
+			break;
+
+		if (memcmp(sector_buf, data + done, chunk) == 0) {
+			VERBOSE("qspi: Sector @ %08zx unchanged\n", offset + done);
+			blank = false;
+		} else {
+			blank = qspi_is_blank(sector_buf, chunk);
+			VERBOSE("qspi: Sector @ %08zx %s\n", offset + done,
+				blank ? "blank, program" : "changed, erase and program");
+			if (!blank) {
+				run += chunk;
+				st.rewritten++;
+				continue;
+			}
+		}
+
+		if (run != 0) {
+			ret = qspi_update_write(offset + done - run, data + done - run,
+						run, true, &unlocked);
+			run = 0;
+			if (ret != 0)
+				break;
+		}
+
+		if (!blank) {
+			st.skipped++;
+			continue;
+		}
+
+		ret = qspi_update_write(offset + done, data + done, chunk,
+					false, &unlocked);
+		if (ret != 0)
+			break;
+
+		st.programmed++;
+	}
+
+	if (ret == 0 && run != 0)
+		ret = qspi_update_write(offset + done - run, data + done - run,
+					run, true, &unlocked);
+
+	INFO("qspi: Update @ %08x: %u skipped, %u programmed, %u rewritten\n",
+	     offset, st.skipped, st.programmed, st.rewritten);
+
+	if (stats != NULL)
+		*stats = st;
+
+	return ret;
+}
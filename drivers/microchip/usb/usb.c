@@ -16,6 +16,7 @@
 #include <string.h>
 
 #include <drivers/microchip/usb.h>
+#include <platform_def.h>
 
 #include "lan966x_regs.h"
 
@@ -82,7 +83,8 @@
 #define UDPHSEPT_NUMBER 16
 #define UDPHSDMA_NUMBER 7
 
-#define USB_RX_BUFFER_SIZE 128
+#define USB_RX_BUFFER_SIZE 1024 /* Holds at least one high-speed packet */
+#define USB_TX_BUFFER_SIZE 512 /* Largest bulk IN packet (high-speed) */
 
 #define UDPHS_EPTCFG_EPT_SIZE_8 0x0
 #define UDPHS_EPTCFG_EPT_SIZE_16 0x1
@@ -138,6 +140,9 @@ struct cdc {
 	uint8_t rx_buffer[USB_RX_BUFFER_SIZE];
 	uint16_t rx_buffer_begin;
 	uint16_t rx_buffer_end;
+	uint8_t tx_buffer[USB_TX_BUFFER_SIZE];
+	uint16_t tx_buffer_len;
+	bool tx_zlp;
 };
 
 struct cdc_line_coding {
@@ -761,41 +766,118 @@ static uint8_t lan966x_usb_is_configured(struct cdc *cdc)
 	return cdc->current_configuration && cdc->set_line;
 }
 
+static uint32_t lan966x_usb_rx_free(struct cdc *cdc)
+{
+	return (USB_RX_BUFFER_SIZE - 1) -
+		((cdc->rx_buffer_end - cdc->rx_buffer_begin + USB_RX_BUFFER_SIZE) %
+		 USB_RX_BUFFER_SIZE);
+}
+
+/*
+ * Return the byte count of the packet in the current OUT bank, or -1 if
+ * none. The endpoint has two banks, so the host can fill one while the
+ * other is being emptied.
+ */
+static int lan966x_usb_rx_pending(struct cdc *cdc)
+{
+	uint32_t sta;
+
+	if (!lan966x_usb_is_configured(cdc))
+		return -1;
+
+	sta = mmio_read_32(UDPHS0_UDPHS_EPTSTA1(cdc->base));
+	if (!(sta & UDPHS0_UDPHS_EPTSTA1_RXRDY_TXKL_EPTSTA1_M))
+		return -1;
+
+	return (sta & UDPHS0_UDPHS_EPTSTA1_BYTE_COUNT_EPTSTA1_M) >> 20;
+}
+
+static void lan966x_usb_rx_release(struct cdc *cdc)
+{
+	/* Clear the RXRDY indication on endpoint 1: ready for more */
+	mmio_write_32(UDPHS0_UDPHS_EPTCLRSTA1(cdc->base),
+		      UDPHS0_UDPHS_EPTCLRSTA1_RXRDY_TXKL_EPTCLRSTA1(1));
+}
+
 static uint32_t lan966x_usb_read(struct cdc *cdc)
 {
 	uint32_t recv = 0;
 	uint8_t *fifo;
-	uint32_t size;
-	uint8_t *infifo;
+	int size;
 
-	if (!lan966x_usb_is_configured(cdc))
+	size = lan966x_usb_rx_pending(cdc);
+	/* Leave the packet in the bank until it fits */
+	if (size < 0 || (uint32_t) size > lan966x_usb_rx_free(cdc))
 		return 0;
 
-	infifo = (uint8_t *)cdc->ept_fifos + ((64 * 1024) * EP_OUT);
-	/* If RXRDY is indicated on endpoint 1 */
-	if ((mmio_read_32(UDPHS0_UDPHS_EPTSTA1(cdc->base)) &
-	     UDPHS0_UDPHS_EPTSTA1_RXRDY_TXKL_EPTSTA1_M)) {
-		size = (mmio_read_32(UDPHS0_UDPHS_EPTSTA1(cdc->base)) &
-			UDPHS0_UDPHS_EPTSTA1_BYTE_COUNT_EPTSTA1_M) >>
-		       20;
-		fifo = infifo;
-
-		/* Copy data from the endpoint buffer to our rx_buffer */
-		while (size--) {
-			cdc->rx_buffer[cdc->rx_buffer_end] = fifo[recv];
-			recv++;
-
-			cdc->rx_buffer_end =
-				(cdc->rx_buffer_end + 1) % USB_RX_BUFFER_SIZE;
-			if (cdc->rx_buffer_end == cdc->rx_buffer_begin)
+	fifo = (uint8_t *)cdc->ept_fifos + ((64 * 1024) * EP_OUT);
+
+	/* Copy data from the endpoint buffer to our rx_buffer */
+	while (size--) {
+		cdc->rx_buffer[cdc->rx_buffer_end] = fifo[recv];
+		recv++;
+
+		cdc->rx_buffer_end =
+			(cdc->rx_buffer_end + 1) % USB_RX_BUFFER_SIZE;
+	}
+
+	lan966x_usb_rx_release(cdc);
+
+	return recv;
+}
+
+size_t lan966x_usb_read_data(void *data, size_t length)
+{
+	struct cdc *cdc = &setup_cdc;
+	uint64_t timeout = timeout_init_us(TIMEOUT_US_1S);
+	uint8_t *ptr = data, *fifo;
+	size_t done = 0;
+	int size, i;
+
+	/* Data already buffered by getc() */
+	while (done < length && cdc->rx_buffer_begin != cdc->rx_buffer_end) {
+		ptr[done++] = cdc->rx_buffer[cdc->rx_buffer_begin];
+		cdc->rx_buffer_begin =
+			(cdc->rx_buffer_begin + 1) % USB_RX_BUFFER_SIZE;
+	}
+
+	fifo = (uint8_t *)cdc->ept_fifos + ((64 * 1024) * EP_OUT);
+
+	/* Then whole packets, straight from the endpoint bank */
+	while (done < length) {
+		size = lan966x_usb_rx_pending(cdc);
+		if (size < 0) {
+			/* Host gone away or stalled, return short */
+			if (!cdc->current_configuration || !cdc->set_line ||
+			    timeout_elapsed(timeout))
 				break;
+			continue;
 		}
 
-		/* Clear the RXRDY indication on endpoint 1: ready for more */
-		mmio_write_32(UDPHS0_UDPHS_EPTCLRSTA1(cdc->base),
-			      UDPHS0_UDPHS_EPTCLRSTA1_RXRDY_TXKL_EPTCLRSTA1(1));
+		for (i = 0; i < size; i++) {
+			if (done < length) {
+				ptr[done++] = fifo[i];
+			} else {
+				/* Excess goes to the ring, which is empty here */
+				cdc->rx_buffer[cdc->rx_buffer_end] = fifo[i];
+				cdc->rx_buffer_end =
+					(cdc->rx_buffer_end + 1) % USB_RX_BUFFER_SIZE;
+			}
+		}
+
+		lan966x_usb_rx_release(cdc);
+		timeout = timeout_init_us(TIMEOUT_US_1S);
 	}
-	return 0;
+
+	return done;
+}
+
+static uint16_t lan966x_usb_tx_packet_size(struct cdc *cdc)
+{
+	/* Get the packet size via the speed indication */
+	return mmio_read_32(UDPHS0_UDPHS_INTSTA(cdc->base)) &
+		UDPHS0_UDPHS_INTSTA_SPEED_M ?
+		MAXPACKETSIZEIN : OSCMAXPACKETSIZEIN;
 }
 
 static uint32_t lan966x_usb_write(struct cdc *cdc, const uint8_t *data,
@@ -812,11 +894,7 @@ static uint32_t lan966x_usb_write(struct cdc *cdc, const uint8_t *data,
 	outfifo = (uint8_t *)cdc->ept_fifos + ((64 * 1024) * EP_IN);
 	if (length) {
 		VERBOSE("lan966x: %s, send: %u\n", __func__, length);
-		/* Get the packet size via the speed indication */
-		packet_size = mmio_read_32(UDPHS0_UDPHS_INTSTA(cdc->base)) &
-					      UDPHS0_UDPHS_INTSTA_SPEED_M ?
-					    MAXPACKETSIZEIN :
-					    OSCMAXPACKETSIZEIN;
+		packet_size = lan966x_usb_tx_packet_size(cdc);
 
 		/* Wait for the TXRDY indication on endpoint 2 */
 		while ((mmio_read_32(UDPHS0_UDPHS_EPTSTA2(cdc->base)) &
@@ -858,20 +936,76 @@ static uint32_t lan966x_usb_write(struct cdc *cdc, const uint8_t *data,
 }
 
 
+/* Send a zero length packet, terminating a transfer of full packets */
+static void lan966x_usb_write_zlp(struct cdc *cdc)
+{
+	if (!lan966x_usb_is_configured(cdc))
+		return;
+
+	/* Wait for the TXRDY indication on endpoint 2 */
+	while ((mmio_read_32(UDPHS0_UDPHS_EPTSTA2(cdc->base)) &
+		UDPHS0_UDPHS_EPTSTA2_TXRDY_EPTSTA2_M))
+		;
+
+	mmio_write_32(UDPHS0_UDPHS_EPTSETSTA2(cdc->base),
+		      UDPHS0_UDPHS_EPTSETSTA2_TXRDY_EPTSETSTA2(1));
+}
+
+/* Send the buffered TX data, and end the transfer if 'flush' */
+static void lan966x_usb_tx_send(struct cdc *cdc, bool flush)
+{
+	if (cdc->tx_buffer_len) {
+		lan966x_usb_write(cdc, cdc->tx_buffer, cdc->tx_buffer_len);
+		cdc->tx_zlp = (cdc->tx_buffer_len == lan966x_usb_tx_packet_size(cdc));
+		cdc->tx_buffer_len = 0;
+	}
+
+	if (flush && cdc->tx_zlp) {
+		lan966x_usb_write_zlp(cdc);
+		cdc->tx_zlp = false;
+	}
+}
+
+void lan966x_usb_write_data(const void *data, size_t length)
+{
+	struct cdc *cdc = &setup_cdc;
+	const uint8_t *ptr = data;
+	uint16_t packet_size = lan966x_usb_tx_packet_size(cdc);
+	size_t chunk;
+
+	while (length) {
+		/* The speed may have dropped since the data was buffered */
+		if (cdc->tx_buffer_len >= packet_size) {
+			lan966x_usb_tx_send(cdc, false);
+			continue;
+		}
+
+		chunk = MIN(length, (size_t) (packet_size - cdc->tx_buffer_len));
+		memcpy(cdc->tx_buffer + cdc->tx_buffer_len, ptr, chunk);
+		cdc->tx_buffer_len += chunk;
+		ptr += chunk;
+		length -= chunk;
+
+		if (cdc->tx_buffer_len == packet_size)
+			lan966x_usb_tx_send(cdc, false);
+	}
+}
+
 static int lan966x_usb_putc(int ch, struct console *con)
 {
-	uint8_t buffer[1] = { ch };
+	uint8_t c = ch;
 
-	lan966x_usb_write(&setup_cdc, buffer, 1);
+	lan966x_usb_write_data(&c, 1);
 	return 0;
 }
 
 static int lan966x_usb_getc(struct console *con)
 {
 	struct cdc *cdc = &setup_cdc;
-	int val = 0;
+	int val = ERROR_NO_PENDING_CHAR;
 
-	lan966x_usb_read(cdc);
+	if (cdc->rx_buffer_begin == cdc->rx_buffer_end)
+		lan966x_usb_read(cdc);
 	if (cdc->rx_buffer_begin != cdc->rx_buffer_end) {
 		val = cdc->rx_buffer[cdc->rx_buffer_begin];
 		if (++cdc->rx_buffer_begin >= USB_RX_BUFFER_SIZE) {
@@ -884,8 +1018,9 @@ static int lan966x_usb_getc(struct console *con)
 static void lan966x_usb_flush(struct console *con)
 {
 	struct cdc *cdc = &setup_cdc;
-	cdc->rx_buffer_begin = 0;
-	cdc->rx_buffer_end = 0;
+
+	/* Only TX is flushed, pipelined RX data must survive a flush */
+	lan966x_usb_tx_send(cdc, true);
 }
 
 static console_t lan966x_usb_console = {
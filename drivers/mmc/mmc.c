@@ -264,66 +264,66 @@ static int mmc_read_ext_csd(void)
 	return 0;
 }
 
-static int mmc_switch_emmc(unsigned int clk, unsigned int bus_width)
-{
-	static const char *hs_modes[] = {"Standard", "HS", "HS200", "HS400"};
-	static const struct {
-		uint32_t dev_mask;
-		uint32_t hs_mode;
-		uint32_t bus_width;
-		unsigned int min_clock, max_clock;
-	} modes[] = {
-		{
-			MMC_DEV_TYPE_HS_26MHZ,
-			MMC_BOOT_MODE_HS_TIMING,
-			BIT(MMC_BUS_WIDTH_1) | BIT(MMC_BUS_WIDTH_4) | BIT(MMC_BUS_WIDTH_8),
-			0U, 26000000U,
-		}, {
-			MMC_DEV_TYPE_HS_52MHZ,
-			MMC_BOOT_MODE_HS_TIMING,
-			BIT(MMC_BUS_WIDTH_1) | BIT(MMC_BUS_WIDTH_4) | BIT(MMC_BUS_WIDTH_8),
-			0U, 52000000U,
-		}, {
-			MMC_DEV_TYPE_SDR_HS200_18V | MMC_DEV_TYPE_SDR_HS200_12V,
-			MMC_BOOT_MODE_HS200,
-			BIT(MMC_BUS_WIDTH_4) | BIT(MMC_BUS_WIDTH_8),
-			0U, 200000000U,
-		}
-	};
-	int i, ret;
-
-	/* Try bumping speed with proper ext_csd data at hand */
-	uint8_t hs_mode, dt = mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
-	for (i = 0; i < ARRAY_SIZE(modes); i++) {
-		if (dt & modes[i].dev_mask &&
-		    clk >= modes[i].min_clock && clk <= modes[i].max_clock &&
-		    modes[i].bus_width & BIT(bus_width)) {
-			hs_mode = modes[i].hs_mode;
-			VERBOSE("Using MMC mode %d, hs_mode %d, dt = %02x\n", i, hs_mode, dt);
-			goto found;
-		}
+static const char *const hs_modes[] = {"Standard", "HS", "HS200", "HS400"};
+
+static const struct {
+	uint32_t dev_mask;
+	uint32_t hs_mode;
+	uint32_t bus_width;
+	unsigned int min_clock, max_clock;
+} emmc_modes[] = {
+	{
+		MMC_DEV_TYPE_HS_26MHZ,
+		MMC_BOOT_MODE_HS_TIMING,
+		BIT(MMC_BUS_WIDTH_1) | BIT(MMC_BUS_WIDTH_4) | BIT(MMC_BUS_WIDTH_8),
+		0U, 26000000U,
+	}, {
+		MMC_DEV_TYPE_HS_52MHZ,
+		MMC_BOOT_MODE_HS_TIMING,
+		BIT(MMC_BUS_WIDTH_1) | BIT(MMC_BUS_WIDTH_4) | BIT(MMC_BUS_WIDTH_8),
+		0U, 52000000U,
+	}, {
+		MMC_DEV_TYPE_HSDDR_18V | MMC_DEV_TYPE_HSDDR_12V,
+		MMC_BOOT_MODE_HS_TIMING,
+		BIT(MMC_BUS_WIDTH_DDR_4) | BIT(MMC_BUS_WIDTH_DDR_8),
+		0U, 52000000U,
+	}, {
+		MMC_DEV_TYPE_SDR_HS200_18V | MMC_DEV_TYPE_SDR_HS200_12V,
+		MMC_BOOT_MODE_HS200,
+		BIT(MMC_BUS_WIDTH_4) | BIT(MMC_BUS_WIDTH_8),
+		0U, 200000000U,
 	}
+};
 
-	NOTICE("MMC using fallback mode, card DEVICE_TYPE = %02x\n", dt);
-	clk = MIN(clk, 26000000U); /* Clamp clock */
-	bus_width = MMC_BUS_WIDTH_1; /* Very defensive */
-	hs_mode = MMC_BOOT_MODE_BACKWARD;
+static bool mmc_bus_width_is_ddr(unsigned int bus_width)
+{
+	return (bus_width == MMC_BUS_WIDTH_DDR_4) ||
+		(bus_width == MMC_BUS_WIDTH_DDR_8);
+}
+
+static int mmc_select_emmc_mode(uint8_t hs_mode, unsigned int clk,
+				unsigned int bus_width)
+{
+	int ret;
 
-found:
 	VERBOSE("MMC selecting %s mode, bus width code %d, clock = %d\n",
 		hs_modes[hs_mode], bus_width, clk);
 
-	/* Now, set bus width */
-	ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, bus_width);
-	if (ret != 0) {
-		NOTICE("MMC set bus width %d error: %d\n", bus_width, ret);
-		return ret;
+	if (mmc_bus_width_is_ddr(bus_width)) {
+		/* DDR bus width is only accepted in high speed timing */
+		ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, hs_mode);
+		if (ret == 0) {
+			ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, bus_width);
+		}
+	} else {
+		ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, bus_width);
+		if (ret == 0) {
+			ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, hs_mode);
+		}
 	}
-
-	/* Set timing interface mode */
-	ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, hs_mode);
-	if (ret) {
-		NOTICE("MMC set timing interface %d error: %d\n", hs_mode, ret);
+	if (ret != 0) {
+		NOTICE("MMC set %s mode, bus width %d error: %d\n",
+		       hs_modes[hs_mode], bus_width, ret);
 		return ret;
 	}
 
@@ -334,6 +334,15 @@ found:
 		return ret;
 	}
 
+	/* HS200 needs the sampling point found before data can be moved */
+	if (hs_mode == MMC_BOOT_MODE_HS200 && ops->execute_tuning != NULL) {
+		ret = ops->execute_tuning(bus_width);
+		if (ret) {
+			NOTICE("MMC HS200 tuning failed: %d\n", ret);
+			return ret;
+		}
+	}
+
 	/* Check device state now the clock has been set */
 	do {
 		ret = mmc_device_state();
@@ -348,16 +357,79 @@ found:
 		ERROR("MMC unable to read EXT_CSD after clock change: %d\n", ret);
 		return ret;
 	}
-	if (mmc_ext_csd[CMD_EXTCSD_HS_TIMING] == hs_mode) {
-		VERBOSE("MMC change to %s mode verified\n", hs_modes[hs_mode]);
-	} else {
+	if (mmc_ext_csd[CMD_EXTCSD_HS_TIMING] != hs_mode) {
 		ERROR("MMC unable to change mode: expect %d, got %d\n",
 		      hs_mode, mmc_ext_csd[CMD_EXTCSD_HS_TIMING]);
+		return -EIO;
 	}
 
+	VERBOSE("MMC change to %s mode verified\n", hs_modes[hs_mode]);
+
 	return 0;
 }
 
+static int mmc_switch_emmc(unsigned int clk, unsigned int bus_width)
+{
+	uint8_t dt = mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
+	unsigned int i;
+	int ret;
+
+	/* DDR is only defined up to DDR52 */
+	if (mmc_bus_width_is_ddr(bus_width)) {
+		clk = MIN(clk, 52000000U);
+	}
+
+	/* Try bumping speed with proper ext_csd data at hand */
+	for (;;) {
+		for (i = 0; i < ARRAY_SIZE(emmc_modes); i++) {
+			if (dt & emmc_modes[i].dev_mask &&
+			    clk >= emmc_modes[i].min_clock &&
+			    clk <= emmc_modes[i].max_clock &&
+			    emmc_modes[i].bus_width & BIT(bus_width)) {
+				break;
+			}
+		}
+		if (i == ARRAY_SIZE(emmc_modes)) {
+			/* Card without DDR: SDR at the same width */
+			if (mmc_bus_width_is_ddr(bus_width)) {
+				bus_width = (bus_width == MMC_BUS_WIDTH_DDR_8) ?
+					MMC_BUS_WIDTH_8 : MMC_BUS_WIDTH_4;
+				continue;
+			}
+			break;
+		}
+
+		VERBOSE("Using MMC mode %d, hs_mode %d, dt = %02x\n",
+			i, emmc_modes[i].hs_mode, dt);
+		ret = mmc_select_emmc_mode(emmc_modes[i].hs_mode, clk, bus_width);
+		if (ret == 0) {
+			return 0;
+		}
+
+		/* Step down: HS200 and DDR52 to HS52, HS to fallback mode */
+		if (emmc_modes[i].hs_mode == MMC_BOOT_MODE_HS200) {
+			clk = MIN(clk, 52000000U);
+		} else if (mmc_bus_width_is_ddr(bus_width)) {
+			bus_width = (bus_width == MMC_BUS_WIDTH_DDR_8) ?
+				MMC_BUS_WIDTH_8 : MMC_BUS_WIDTH_4;
+		} else {
+			break;
+		}
+
+		/* Back to a clock the card handles in any timing mode */
+		ret = ops->set_ios(MIN(clk, 26000000U), bus_width);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	NOTICE("MMC using fallback mode, card DEVICE_TYPE = %02x\n", dt);
+	clk = MIN(clk, 26000000U); /* Clamp clock */
+	bus_width = MMC_BUS_WIDTH_1; /* Very defensive */
+
+	return mmc_select_emmc_mode(MMC_BOOT_MODE_BACKWARD, clk, bus_width);
+}
+
 static int mmc_set_ios(unsigned int clk, unsigned int bus_width)
 {
 	int ret;
@@ -27,6 +27,7 @@
 #define BANK_SIZE		0x1000000U
 
 #define SPI_READY_TIMEOUT_US	40000U
+#define SPI_BLOCK_ERASE_TIMEOUT_US	2000000U
 
 static struct nor_device nor_dev;
 
@@ -112,10 +113,10 @@ static int spi_nor_ready(void)
 	return (((sr & SR_WIP) == 0U) ? 0 : 1);
 }
 
-static int spi_nor_wait_ready(void)
+static int spi_nor_wait_ready_us(uint32_t timeout_us)
 {
 	int ret;
-	uint64_t timeout = timeout_init_us(SPI_READY_TIMEOUT_US);
+	uint64_t timeout = timeout_init_us(timeout_us);
 
 	while (!timeout_elapsed(timeout)) {
 		ret = spi_nor_ready();
@@ -127,6 +128,11 @@ static int spi_nor_wait_ready(void)
 	return -ETIMEDOUT;
 }
 
+static int spi_nor_wait_ready(void)
+{
+	return spi_nor_wait_ready_us(SPI_READY_TIMEOUT_US);
+}
+
 static int spi_nor_macronix_quad_enable(void)
 {
 	uint8_t sr;
@@ -434,12 +440,32 @@ int spi_nor_init(unsigned long long *size, unsigned int *erase_size)
 	return ret;
 }
 
-static int spi_nor_erase_sector(uint32_t addr)
+static int spi_nor_read_sfdp(uint32_t addr, void *buf, size_t len)
+{
+	struct spi_mem_op op;
+
+	zeromem(&op, sizeof(struct spi_mem_op));
+	op.cmd.opcode = SPI_NOR_OP_READ_SFDP;
+	op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.addr.val = addr;
+	op.addr.nbytes = 3U;
+	op.addr.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.dummy.nbytes = 1U;
+	op.dummy.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.data.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.data.dir = SPI_MEM_DATA_IN;
+	op.data.nbytes = len;
+	op.data.buf = buf;
+
+	return spi_mem_exec_op(&op);
+}
+
+static int spi_nor_erase_op(uint8_t cmd, uint32_t size, uint32_t addr)
 {
 	uint8_t buf[3];
 	int i, ret;
 
-	VERBOSE("%s: Erase %d bytes @ %08x\n", __func__, nor_dev.erase_size, addr);
+	VERBOSE("%s: Erase %d bytes @ %08x\n", __func__, size, addr);
 
 	ret = spi_nor_write_en();
 	if (ret != 0)
@@ -451,26 +477,55 @@ static int spi_nor_erase_sector(uint32_t addr)
 		addr >>= 8;
 	}
 
-	return spi_nor_reg(nor_dev.erase_cmd, buf, sizeof(buf), SPI_MEM_DATA_OUT);
+	return spi_nor_reg(cmd, buf, sizeof(buf), SPI_MEM_DATA_OUT);
+}
+
+static int spi_nor_erase_sector(uint32_t addr)
+{
+	return spi_nor_erase_op(nor_dev.erase_cmd, nor_dev.erase_size, addr);
+}
+
+int spi_nor_erase_block_start(unsigned int offset, size_t length)
+{
+	const struct spi_nor_erase_type *type;
+	int ret;
+
+	if (offset & (nor_dev.erase_size - 1))
+		return -EINVAL;
+
+	/* Discover the available erase sizes on first use */
+	if (nor_dev.erase_types[0].size == 0U)
+		spi_nor_erase_types_init(nor_dev.erase_types, spi_nor_read_sfdp,
+					 nor_dev.erase_size, nor_dev.erase_cmd);
+
+	type = spi_nor_erase_select(nor_dev.erase_types, offset, length);
+	ret = spi_nor_erase_op(type->opcode, type->size, offset);
+	if (ret)
+		return ret;
+
+	return (int) type->size;
 }
 
 int spi_nor_erase(unsigned int offset, size_t length)
 {
 	uint32_t addr;
-	int ret;
+	int ret = 0, size;
 
 	if (offset & (nor_dev.erase_size - 1)) {
 		ERROR("%s: Erase error @ %08x - illegal offset\n", __func__, offset);
 		return -EINVAL;
 	}
 
-	for (addr = offset; addr < (offset + length); addr += nor_dev.erase_size) {
-		ret = spi_nor_erase_sector(addr);
-		if (ret) {
+	for (addr = offset; addr < (offset + length); addr += size) {
+		size = spi_nor_erase_block_start(addr, offset + length - addr);
+		if (size < 0) {
+			ret = size;
 			ERROR("%s: Erase error @ %08x = %d\n", __func__, offset, ret);
 			break;
 		}
-		ret = spi_nor_wait_ready();
+		ret = spi_nor_wait_ready_us((uint32_t) size > nor_dev.erase_size ?
+					    SPI_BLOCK_ERASE_TIMEOUT_US :
+					    SPI_READY_TIMEOUT_US);
 		if (ret) {
 			ERROR("%s: Erase ready timeout @ %08x = %d\n", __func__, offset, ret);
 			break;
@@ -483,20 +538,50 @@ int spi_nor_erase(unsigned int offset, size_t length)
 	return ret;
 }
 
-static int spi_nor_write_data_page(uint32_t offset, uintptr_t buffer, size_t length)
+int spi_nor_erase_start(unsigned int offset)
+{
+	if (offset & (nor_dev.erase_size - 1))
+		return -EINVAL;
+
+	return spi_nor_erase_sector(offset);
+}
+
+int spi_nor_write_page_start(unsigned int offset, uintptr_t buffer, size_t length)
 {
 	int ret;
 
+	/* Must not cross a page boundary */
+	if ((offset & (nor_dev.page_size - 1)) + length > nor_dev.page_size)
+		return -EINVAL;
+
 	/* Write enable */
 	ret = spi_nor_write_en();
 	if (ret != 0)
-		goto fail;
+		return ret;
 
 	/* Now write */
 	nor_dev.pageprog_op.addr.val = offset;
 	nor_dev.pageprog_op.data.buf = (void *)buffer;
 	nor_dev.pageprog_op.data.nbytes = length;
-	ret = spi_mem_exec_op(&nor_dev.pageprog_op);
+
+	return spi_mem_exec_op(&nor_dev.pageprog_op);
+}
+
+int spi_nor_busy(void)
+{
+	return spi_nor_ready();
+}
+
+void spi_nor_write_end(void)
+{
+	(void) spi_nor_write_dis();
+}
+
+static int spi_nor_write_data_page(uint32_t offset, uintptr_t buffer, size_t length)
+{
+	int ret;
+
+	ret = spi_nor_write_page_start(offset, buffer, length);
 	if (ret)
 		goto fail;
 
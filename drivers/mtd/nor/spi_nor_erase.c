@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <common/debug.h>
+#include <drivers/spi_nor.h>
+#include <lib/utils.h>
+
+#define SFDP_SIGNATURE		0x50444653U	/* "SFDP" */
+#define SFDP_HEADER_SIZE	16U		/* Header and first parameter header */
+#define SFDP_BFPT_ID		0xFF00U		/* Basic Flash Parameter Table */
+#define SFDP_BFPT_MIN_DWORDS	9U
+#define SFDP_BFPT_ERASE_OFFSET	(7U * 4U)	/* DWORD 8 and 9: erase types */
+
+/* Fallback when SFDP is not available: 64KiB block erase is universal */
+#define SPI_NOR_DEFAULT_BLOCK	(64U * 1024U)
+
+/* Erase opcodes the QSPI controllers know how to issue */
+static bool spi_nor_erase_opcode_valid(uint8_t opcode)
+{
+	return (opcode == SPI_NOR_OP_BE_4K ||
+		opcode == SPI_NOR_OP_BE_32K ||
+		opcode == SPI_NOR_OP_SE);
+}
+
+static void spi_nor_erase_add(struct spi_nor_erase_type *types,
+			      uint32_t size, uint8_t opcode)
+{
+	unsigned int i, j;
+
+	/* Keep sorted, largest first, without duplicate sizes */
+	for (i = 0; i < SPI_NOR_MAX_ERASE_TYPES && types[i].size > size; i++)
+		;
+
+	if (i == SPI_NOR_MAX_ERASE_TYPES || types[i].size == size)
+		return;
+
+	for (j = SPI_NOR_MAX_ERASE_TYPES - 1; j > i; j--)
+		types[j] = types[j - 1];
+
+	types[i].size = size;
+	types[i].opcode = opcode;
+}
+
+static int spi_nor_sfdp_parse(spi_nor_sfdp_read_t read,
+			      struct spi_nor_erase_type *types,
+			      uint32_t min_size)
+{
+	uint8_t hdr[SFDP_HEADER_SIZE], erase[8];
+	uint32_t sig, ptr;
+	uint16_t id;
+	unsigned int i;
+	int ret;
+
+	ret = read(0, hdr, sizeof(hdr));
+	if (ret != 0)
+		return ret;
+
+	sig = hdr[0] | (hdr[1] << 8) | (hdr[2] << 16) | ((uint32_t) hdr[3] << 24);
+	if (sig != SFDP_SIGNATURE)
+		return -ENOENT;
+
+	/* The first parameter header is always the BFPT */
+	id = hdr[8] | (hdr[15] << 8);
+	if (id != SFDP_BFPT_ID || hdr[11] < SFDP_BFPT_MIN_DWORDS)
+		return -ENOENT;
+
+	ptr = hdr[12] | (hdr[13] << 8) | (hdr[14] << 16);
+	ret = read(ptr + SFDP_BFPT_ERASE_OFFSET, erase, sizeof(erase));
+	if (ret != 0)
+		return ret;
+
+	/* Erase type 1-4: size exponent, opcode. Size exponent 0 = unused */
+	for (i = 0; i < sizeof(erase); i += 2) {
+		uint32_t size;
+
+		if (erase[i] == 0U || erase[i] >= 32U)
+			continue;
+
+		size = 1U << erase[i];
+		VERBOSE("SFDP: Erase %d bytes, opcode %02x\n", size, erase[i + 1]);
+		if (size > min_size && (size % min_size) == 0U &&
+		    spi_nor_erase_opcode_valid(erase[i + 1]))
+			spi_nor_erase_add(types, size, erase[i + 1]);
+	}
+
+	return 0;
+}
+
+void spi_nor_erase_types_init(struct spi_nor_erase_type *types,
+			      spi_nor_sfdp_read_t read,
+			      uint32_t min_size, uint8_t min_opcode)
+{
+	unsigned int i;
+
+	zeromem(types, SPI_NOR_MAX_ERASE_TYPES * sizeof(*types));
+	spi_nor_erase_add(types, min_size, min_opcode);
+
+	if (read == NULL || spi_nor_sfdp_parse(read, types, min_size) != 0) {
+		INFO("SPI NOR: No SFDP, using default erase sizes\n");
+		if (min_size < SPI_NOR_DEFAULT_BLOCK)
+			spi_nor_erase_add(types, SPI_NOR_DEFAULT_BLOCK, SPI_NOR_OP_SE);
+	}
+
+	for (i = 0; i < SPI_NOR_MAX_ERASE_TYPES && types[i].size; i++)
+		VERBOSE("SPI NOR: Erase type %d: %d bytes, opcode %02x\n",
+			i, types[i].size, types[i].opcode);
+}
+
+const struct spi_nor_erase_type *spi_nor_erase_select(const struct spi_nor_erase_type *types,
+						      uint32_t addr, size_t remaining)
+{
+	unsigned int i;
+
+	for (i = 0; i < SPI_NOR_MAX_ERASE_TYPES && types[i].size; i++) {
+		if ((addr & (types[i].size - 1U)) == 0U &&
+		    types[i].size <= remaining)
+			return &types[i];
+	}
+
+	/* Tail smaller than any erase size: use the smallest */
+	assert(i > 0U);
+	return &types[i - 1U];
+}
@@ -577,6 +577,8 @@
 #define PMCR		p15, 0, c9, c12, 0
 #define CNTHP_TVAL	p15, 4, c14, c2, 0
 #define CNTHP_CTL	p15, 4, c14, c2, 1
+/* Physical timer, accessed from Secure state this is the Secure instance */
+#define CNTPS_CTL	p15, 0, c14, c2, 1
 
 /* AArch32 coproc registers for 32bit MMU descriptor support */
 #define PRRR		p15, 0, c10, c2, 0
@@ -612,6 +614,7 @@
 #define CNTPCT_64	p15, 0, c14
 #define HTTBR_64	p15, 4, c2
 #define CNTHP_CVAL_64	p15, 6, c14
+#define CNTPS_CVAL_64	p15, 2, c14
 #define PAR_64		p15, 0, c7
 
 /* 64 bit GICv3 CPU Interface system register defines. The format is: coproc, opt1, CRm */
@@ -253,6 +253,8 @@ DEFINE_COPROCR_RW_FUNCS(hstr, HSTR)
 DEFINE_COPROCR_RW_FUNCS(cnthp_ctl_el2, CNTHP_CTL)
 DEFINE_COPROCR_RW_FUNCS(cnthp_tval_el2, CNTHP_TVAL)
 DEFINE_COPROCR_RW_FUNCS_64(cnthp_cval_el2, CNTHP_CVAL_64)
+DEFINE_COPROCR_RW_FUNCS(cntps_ctl_el1, CNTPS_CTL)
+DEFINE_COPROCR_RW_FUNCS_64(cntps_cval_el1, CNTPS_CVAL_64)
 
 #define get_cntp_ctl_enable(x)  (((x) >> CNTP_CTL_ENABLE_SHIFT) & \
 					 CNTP_CTL_ENABLE_MASK)
@@ -413,6 +415,9 @@ static inline unsigned int get_current_el(void)
 #define read_cnthp_cval_el2()	read64_cnthp_cval_el2()
 #define write_cnthp_cval_el2(v)	write64_cnthp_cval_el2(v)
 
+#define read_cntps_cval_el1()	read64_cntps_cval_el1()
+#define write_cntps_cval_el1(v)	write64_cntps_cval_el1(v)
+
 #define read_amcntenset0_el0()	read_amcntenset0()
 #define read_amcntenset1_el0()	read_amcntenset1()
 
@@ -75,6 +75,8 @@ void console_switch_state(unsigned int new_state);
 int console_putc(int c);
 /* Read a character (blocking) from any console registered for current state. */
 int console_getc(void);
+/* Read a character if one is pending, else return ERROR_NO_PENDING_CHAR. */
+int console_try_getc(void);
 /* Flush all consoles registered for the current state. */
 void console_flush(void);
 
@@ -7,9 +7,14 @@
 #ifndef IO_FIP_H
 #define IO_FIP_H
 
+#include <tools_share/firmware_image_package.h>
+
 struct io_dev_connector;
 
 int register_io_dev_fip(const struct io_dev_connector **dev_con);
 int fip_dev_get_plat_toc_flag(io_dev_info_t *dev_info, uint16_t *plat_toc_flag);
+int fip_dev_get_toc_entry(io_dev_info_t *dev_info, const uuid_t *uuid,
+			  fip_toc_entry_t *entry);
+void fip_dev_invalidate_toc_index(void);
 
 #endif /* IO_FIP_H */
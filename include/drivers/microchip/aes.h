@@ -27,4 +27,10 @@ int aes_gcm_encrypt(void *data_ptr, size_t len,
 		    const void *iv, unsigned int iv_len,
 		    void *tag, unsigned int tag_len);
 
+int aes_gcm_encrypt_start(size_t data_len,
+			  const void *key, unsigned int key_len,
+			  const void *iv, unsigned int iv_len);
+
+int aes_gcm_encrypt_finish(void *tag, unsigned int tag_len);
+
 #endif  /* MICROCHIP_AES */
@@ -26,6 +26,7 @@ typedef struct lan966x_mmc_params {
 	int bus_width;
 	unsigned int flags;
 	enum mmc_device_type mmc_dev_type;
+	bool io_1v8;		/* Board VCCQ is 1.8V, needed for HS200/DDR52 */
 } lan966x_mmc_params_t;
 
 void lan966x_mmc_init(lan966x_mmc_params_t * params,
@@ -30,6 +30,9 @@ int otp_write_bytes(unsigned int offset, unsigned int nbytes, const uint8_t *src
 int otp_read_uint32(unsigned int offset, uint32_t *dst);
 int otp_write_uint32(unsigned int offset, uint32_t w);
 int otp_read_bytes_raw(unsigned int offset, unsigned int nbytes, uint8_t *dst);
+void otp_read_begin(void);
+void otp_read_end(void);
+unsigned int otp_write_generation(void);
 
 int otp_write_regions(void);
 
@@ -7,6 +7,9 @@
 #ifndef TFA_OTP_TAGS_H
 #define TFA_OTP_TAGS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 enum otp_tag_type {
 	otp_tag_type_invalid,
 	otp_tag_type_password,
@@ -17,11 +20,35 @@ enum otp_tag_type {
 	otp_tag_type_fit_config,
 };
 
+#define OTP_TAG_CACHE_MAGIC	0x47415454U	/* "TTAG" */
+#define OTP_TAG_CACHE_ENTRIES	32U
+#define OTP_TAG_CACHE_DATA	512U
+
+struct otp_tag_index {
+	uint16_t tag;
+	uint16_t off;		/* In data[] */
+	uint16_t len;
+};
+
+/* Tag index and payloads, built by one scan, handed from stage to stage */
+struct otp_tag_cache {
+	uint32_t magic;
+	uint16_t count;
+	uint16_t used;		/* Of data[] */
+	uint32_t complete;	/* All tags fit */
+	struct otp_tag_index idx[OTP_TAG_CACHE_ENTRIES];
+	uint8_t data[OTP_TAG_CACHE_DATA];
+	uint32_t crc;		/* CRC32C of the above */
+};
+
 /*
  * Returns number of bytes read from OTP - or < 0 if error occurred.
  */
 int otp_tag_get(enum otp_tag_type tag, void *buf, size_t buf_size);
 
+uintptr_t otp_tag_handoff(void);
+void otp_tag_inherit(uintptr_t prev, uintptr_t base, uintptr_t limit);
+
 static inline int otp_tag_get_string(enum otp_tag_type tag, char *buf, size_t buf_size)
 {
 	int ret = otp_tag_get(tag, buf, buf_size - 1);
@@ -20,6 +20,45 @@ int qspi_read(unsigned int offset, uintptr_t buffer, size_t length,
 	      size_t *length_read);
 unsigned int qspi_get_spi_mode(void);
 
+/* Granularity of qspi_erase_start() and qspi_program_start() */
+#define QSPI_SECTOR_SIZE	(4 * 1024U)
+#define QSPI_PAGE_SIZE		256U
+
+/*
+ * Non-blocking erase of a single sector and program of a single page,
+ * allowing the NOR to work while the CPU does something else. A
+ * sequence is started with qspi_write_begin(), each operation must be
+ * polled with qspi_busy() (0 = ready, 1 = busy, negative on error)
+ * before the next one is started, and the sequence is ended with
+ * qspi_write_end().
+ */
+int qspi_write_begin(void);
+int qspi_erase_start(uint32_t offset);
+/*
+ * As qspi_erase_start(), using the largest erase the device supports
+ * that is aligned at 'offset' and within 'len'. Returns the number of
+ * bytes being erased, or a negative error.
+ */
+int qspi_erase_block_start(uint32_t offset, size_t len);
+int qspi_program_start(uint32_t offset, const void *buf, size_t len);
+int qspi_busy(void);
+void qspi_write_end(void);
+
+struct qspi_update_stats {
+	uint32_t skipped;	/* Unchanged, not touched */
+	uint32_t programmed;	/* Blank, programmed without erase */
+	uint32_t rewritten;	/* Erased and programmed */
+};
+
+/*
+ * Differential write: each sector is read back and compared to the new
+ * data, and only sectors that differ are written. The erase is skipped
+ * for sectors that are already blank. Optionally returns the number of
+ * sectors handled each way in 'stats'.
+ */
+int qspi_update(uint32_t offset, const void *buf, size_t len,
+		struct qspi_update_stats *stats);
+
 /*
  * Platform can implement this to override default QSPI clock setup.
  *
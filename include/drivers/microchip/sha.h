@@ -24,5 +24,6 @@ int sha_verify(lan966x_sha_type_t hash_type, const void *input, size_t len, cons
 void *sha_calc_init(lan966x_sha_type_t hash_type, size_t data_len, size_t hash_len);
 void sha_update(void *state, const void *input, size_t len);
 int sha_calc_finish(void *state, void *hash);
+void sha_abort(void *state);
 
 #endif  /* MICROCHIP_SHA */
@@ -16,4 +16,20 @@ struct usb_trim {
 void lan966x_usb_init(const struct usb_trim *trim);
 void lan966x_usb_register_console(void);
 
+/*
+ * Queue data for the USB console. Output is sent in full bulk packets,
+ * and the remainder when the console is flushed. Suitable as the
+ * bootstrap bulk transmit function, see bootstrap_SetTxWrite().
+ */
+void lan966x_usb_write_data(const void *data, size_t length);
+
+/*
+ * Receive 'length' bytes from the USB console, copying whole packets
+ * from the OUT endpoint straight into 'data'. Returns the number of
+ * bytes received, which is short if the device is not configured or
+ * no data arrives for a second. Suitable as the bootstrap bulk receive
+ * function, see bootstrap_SetRxRead().
+ */
+size_t lan966x_usb_read_data(void *data, size_t length);
+
 #endif	/* _DRIVERS_USB_H */
@@ -68,11 +68,58 @@ struct xdmac_req {
 	uint32_t len;
 };
 
+/* Scatter-gather list entry */
+struct xdmac_sg {
+	uintptr_t dst;
+	uintptr_t src;
+	size_t len;
+};
+
+/* DMA pipeline stage operations */
+enum {
+	XDMAC_STAGE_COPY,	/* Copy source to destination, must be first */
+	XDMAC_STAGE_AES,	/* AES-GCM in place at destination */
+	XDMAC_STAGE_SHA,	/* Hash data at destination */
+};
+
+#define XDMAC_PIPELINE_MAX_STAGES	3
+
+struct xdmac_stage {
+	int op;
+	struct {
+		bool encrypt;
+		const void *key;
+		unsigned int key_len;
+		const void *iv;
+		unsigned int iv_len;
+		void *tag;		/* Decrypt: expected, encrypt: result */
+		unsigned int tag_len;
+	} aes;
+	struct {
+		int type;		/* lan966x_sha_type_t */
+		void *hash;		/* Result */
+		size_t hash_len;
+	} sha;
+};
+
+struct xdmac_pipeline {
+	void *dst;
+	const void *src;	/* Only used by copy stage */
+	size_t len;
+	size_t block_size;	/* Zero for default */
+	unsigned int nstages;
+	struct xdmac_stage stages[XDMAC_PIPELINE_MAX_STAGES];
+};
+
+int xdmac_pipeline_run(struct xdmac_pipeline *pl);
+
 void xdmac_bzero(void *dst, size_t count);
 void xdmac_memcpy(void *dst, const void *src, size_t len, int dir, int periph);
+void xdmac_memcpy_sg(const struct xdmac_sg *sg, unsigned int nsg, int dir, int periph);
 
-#if defined(XDMAC_PIPELINE_SUPPPORT) && defined(IMAGE_BL2)
+#if defined(XDMAC_PIPELINE_SUPPPORT) && (defined(IMAGE_BL2) || defined(IMAGE_BL2U))
 void xdmac_qspi_pipeline_read(void *dst, const void *src, size_t len);
+void xdmac_qspi_sha_request(void);
 int xdmac_qspi_get_sha(const void *data, size_t len, int sha_type, void *hash, size_t hash_len);
 bool xdmac_qspi_is_decrypted(const void *dst, size_t len,
 			     const void *key, unsigned int key_len,
@@ -82,6 +129,9 @@ static inline void xdmac_qspi_pipeline_read(void *dst, const void *src, size_t l
 {
 	xdmac_memcpy(dst, src, len, XDMA_DIR_MEM_TO_MEM, XDMA_NONE);
 }
+static inline void xdmac_qspi_sha_request(void)
+{
+}
 static inline
 int xdmac_qspi_get_sha(const void *data, size_t len, int sha_type, void *hash, size_t hash_len)
 {
@@ -94,10 +144,12 @@ bool xdmac_qspi_is_decrypted(const void *dst, size_t len,
 {
 	return false;
 }
-#endif /* defined(XDMAC_PIPELINE_SUPPPORT) && defined(IMAGE_BL2) */
+#endif /* defined(XDMAC_PIPELINE_SUPPPORT) && (defined(IMAGE_BL2) || defined(IMAGE_BL2U)) */
 
 void xdmac_make_req(struct xdmac_req *req, int ch, int dir, int periph, uintptr_t dst, uintptr_t src, size_t len);
-void xdmac_setup_xfer(int ch, void *dst, const void *src, size_t len, int dir, int periph);
+uint32_t xdmac_setup_xfer(int ch, void *dst, const void *src, size_t len, int dir, int periph);
+uint32_t xdmac_setup_sg(int ch, const struct xdmac_sg *sg, unsigned int nsg,
+			int dir, int periph);
 void xdmac_execute_xfers(uint32_t mask);
 
 #endif  /* MICROCHIP_XDMAC */
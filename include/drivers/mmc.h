@@ -149,6 +149,8 @@ struct mmc_ops {
 	int (*prepare)(int lba, uintptr_t buf, size_t size, bool is_write);
 	int (*read)(int lba, uintptr_t buf, size_t size);
 	int (*write)(int lba, const uintptr_t buf, size_t size);
+	/* Optional: sampling point tuning for HS200 */
+	int (*execute_tuning)(unsigned int width);
 };
 
 struct mmc_csd_emmc {
@@ -23,6 +23,8 @@
 /* WRITE OPCODES */
 #define SPI_NOR_OP_PP		0x02U	/* Page program (up to 256 bytes) */
 #define SPI_NOR_OP_BE_4K	0x20U	/* Erase 4KiB block */
+#define SPI_NOR_OP_BE_32K	0x52U	/* Erase 32KiB block */
+#define SPI_NOR_OP_SE		0xD8U	/* Sector erase (usually 64KiB) */
 #define SPI_NOR_OP_ULBPR	0x98U	/* Global block unlock */
 
 /* Used for Spansion flashes only. */
@@ -35,11 +37,19 @@
 #define SPI_NOR_OP_READ_1_2_2	0xBBU	/* Read data bytes (Dual I/O SPI) */
 #define SPI_NOR_OP_READ_1_1_4	0x6BU	/* Read data bytes (Quad Output SPI) */
 #define SPI_NOR_OP_READ_1_4_4	0xEBU	/* Read data bytes (Quad I/O SPI) */
+#define SPI_NOR_OP_READ_SFDP	0x5AU	/* Read SFDP parameters */
 
 /* Flags for NOR specific configuration */
 #define SPI_NOR_USE_FSR		BIT(0)
 #define SPI_NOR_USE_BANK	BIT(1)
 
+#define SPI_NOR_MAX_ERASE_TYPES	4U
+
+struct spi_nor_erase_type {
+	uint32_t size;
+	uint8_t opcode;
+};
+
 struct nor_device {
 	struct spi_mem_op read_op;
 	struct spi_mem_op pageprog_op;
@@ -51,6 +61,7 @@ struct nor_device {
 	uint8_t bank_write_cmd;
 	uint8_t bank_read_cmd;
 	uint8_t erase_cmd;
+	struct spi_nor_erase_type erase_types[SPI_NOR_MAX_ERASE_TYPES];
 };
 
 int spi_nor_read(unsigned int offset, uintptr_t buffer, size_t length,
@@ -59,6 +70,33 @@ int spi_nor_erase(unsigned int offset, size_t length);
 int spi_nor_write(unsigned int offset, uintptr_t buffer, size_t length);
 int spi_nor_init(unsigned long long *device_size, unsigned int *erase_size);
 
+/*
+ * Non-blocking erase of a single sector and program of a single page.
+ * Completion must be polled with spi_nor_busy() (0 = ready, 1 = busy,
+ * negative on error) before the next operation is started, and a
+ * sequence of operations is ended with spi_nor_write_end().
+ */
+int spi_nor_erase_start(unsigned int offset);
+/* As above, with the largest erase aligned at 'offset' within 'length'. Returns its size */
+int spi_nor_erase_block_start(unsigned int offset, size_t length);
+int spi_nor_write_page_start(unsigned int offset, uintptr_t buffer, size_t length);
+int spi_nor_busy(void);
+void spi_nor_write_end(void);
+
+/*
+ * Erase planning. The erase types (largest first) are taken from the
+ * SFDP Basic Flash Parameter Table if 'read' can fetch it, and always
+ * include the 'min_size' erase. spi_nor_erase_select() returns the
+ * largest erase which is aligned at 'addr' and fits in 'remaining'.
+ */
+typedef int (*spi_nor_sfdp_read_t)(uint32_t addr, void *buf, size_t len);
+
+void spi_nor_erase_types_init(struct spi_nor_erase_type *types,
+			      spi_nor_sfdp_read_t read,
+			      uint32_t min_size, uint8_t min_opcode);
+const struct spi_nor_erase_type *spi_nor_erase_select(const struct spi_nor_erase_type *types,
+						      uint32_t addr, size_t remaining);
+
 /*
  * Platform can implement this to override default NOR instance configuration.
  *
@@ -16,9 +16,15 @@
 #if !defined(__aarch64__) || defined(__clang__)
 #	define __crc32b __builtin_arm_crc32b
 #	define __crc32w __builtin_arm_crc32w
+#	define __crc32cb __builtin_arm_crc32cb
+#	define __crc32cw __builtin_arm_crc32cw
+#	define __crc32cd __builtin_arm_crc32cd
 #else
 #	define __crc32b __builtin_aarch64_crc32b
 #	define __crc32w __builtin_aarch64_crc32w
+#	define __crc32cb __builtin_aarch64_crc32cb
+#	define __crc32cw __builtin_aarch64_crc32cw
+#	define __crc32cd __builtin_aarch64_crc32cx
 #endif
 
 #endif	/* ARM_ACLE_H */
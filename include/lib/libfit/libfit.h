@@ -20,12 +20,22 @@ struct fit_context {
 	int cfg_node_offset;
 	uintptr_t entry;
 	uintptr_t dtb;
+	uintptr_t initrd;
+	size_t initrd_size;
 };
 
 bool fit_plat_is_ns_addr(uintptr_t addr);
 
 int fit_plat_default_address(const struct fit_context *fit, fit_prop_t prop, uintptr_t *addr);
 
+/*
+ * Calculate the 'algo' hash of 'len' bytes at 'src'. If 'dst' is
+ * non-zero, the data must also be copied to 'dst' in the same pass.
+ * Returns -ENOTSUP for an algorithm the platform cannot do.
+ */
+int fit_plat_hash(const char *algo, uintptr_t dst, const void *src, size_t len,
+		  void *hash, size_t hash_len);
+
 int fit_init_context(struct fit_context *context, uintptr_t fit_addr);
 
 int fit_select(struct fit_context *context, const char *cfg);
@@ -39,4 +49,10 @@ void fit_fdt_update(struct fit_context *context,
 
 size_t fit_size(const struct fit_context *context);
 
+/*
+ * First free address after the FIT, past the work area used when
+ * uncompressing subimages.
+ */
+uintptr_t fit_scratch_end(const struct fit_context *context);
+
 #endif /* _LIBFIT_H */
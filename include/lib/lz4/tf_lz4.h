@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_LZ4_H
+#define TF_LZ4_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+bool is_lz4(const void *buf, size_t len);
+int unlz4_size(uintptr_t in_buf, size_t in_len, size_t *out_len);
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len);
+
+#endif /* TF_LZ4_H */
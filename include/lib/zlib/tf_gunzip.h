@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+size_t gunzip_work_size(void);
 int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	   size_t out_len, uintptr_t work_buf, size_t work_len);
 
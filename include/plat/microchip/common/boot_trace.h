@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Boot trace event ids - part of the SiP ABI, only append */
+typedef enum {
+	BOOT_TRACE_NONE = 0,
+	BOOT_TRACE_BL1_START,
+	BOOT_TRACE_BL2_START,
+	BOOT_TRACE_BL3X_START,		/* BL31 or SP_MIN */
+	BOOT_TRACE_DDR_INIT,
+	BOOT_TRACE_DDR_DONE,
+	BOOT_TRACE_IMAGE_LOAD,		/* arg: image id */
+	BOOT_TRACE_IMAGE_DONE,		/* arg: image id */
+	BOOT_TRACE_SHA_START,		/* arg: data length */
+	BOOT_TRACE_SHA_DONE,
+	BOOT_TRACE_FIT_START,
+	BOOT_TRACE_FIT_DONE,		/* arg: 0 = ok, 1 = failed */
+	BOOT_TRACE_BL33_START,
+} boot_trace_event_t;
+
+#define BOOT_TRACE_MAGIC	0x54524342U	/* "BCRT" */
+#define BOOT_TRACE_ENTRIES	64U
+
+/* One event, as exported to the normal world */
+struct boot_trace_rec {
+	uint32_t event;
+	uint32_t arg;
+	uint64_t cntpct;
+};
+
+/* Ring of events, handed from stage to stage */
+struct boot_trace {
+	uint32_t magic;
+	uint32_t count;		/* Total events recorded, may exceed ring */
+	struct boot_trace_rec rec[BOOT_TRACE_ENTRIES];
+};
+
+#if MCHP_BOOT_TRACE
+void boot_trace(boot_trace_event_t event, uint32_t arg);
+uintptr_t boot_trace_handoff(void);
+void boot_trace_inherit(uintptr_t prev, uintptr_t base, uintptr_t limit);
+size_t boot_trace_export(struct boot_trace_rec *buf, size_t nrec);
+#else
+static inline void boot_trace(boot_trace_event_t event, uint32_t arg)
+{
+}
+
+static inline uintptr_t boot_trace_handoff(void)
+{
+	return 0;
+}
+
+static inline void boot_trace_inherit(uintptr_t prev, uintptr_t base, uintptr_t limit)
+{
+}
+
+static inline size_t boot_trace_export(struct boot_trace_rec *buf, size_t nrec)
+{
+	return 0;
+}
+#endif
+
+#endif /* BOOT_TRACE_H */
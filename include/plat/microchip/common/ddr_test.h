@@ -9,9 +9,53 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+
+#include <lib/utils_def.h>
 
 uintptr_t ddr_test_data_bus(uintptr_t ddr_base_addr, bool cache);
 uintptr_t ddr_test_addr_bus(uintptr_t ddr_base_addr, size_t ddr_size, bool cache);
 uintptr_t ddr_test_rnd(uintptr_t ddr_base_addr, size_t ddr_size, bool cache, uint32_t seed);
 
+/* ddr_test_dma() test selection */
+#define DDR_TEST_DMA_RND	BIT_32(0)
+#define DDR_TEST_DMA_WALK1	BIT_32(1)
+#define DDR_TEST_DMA_CHECKER	BIT_32(2)
+#define DDR_TEST_DMA_MARCH	BIT_32(3)
+#define DDR_TEST_DMA_ALL	GENMASK_32(3, 0)
+#define DDR_TEST_DMA_TESTS	4U
+#define DDR_TEST_REGIONS	8U	/* Timing is reported per region */
+
+/* DMA test timing, as returned by BOOTSTRAP_DDR_TEST */
+struct ddr_test_result {
+	uint32_t region_size;	/* Bytes per region */
+	uint32_t ms[DDR_TEST_DMA_TESTS][DDR_TEST_REGIONS]; /* Zero if not run */
+};
+
+uintptr_t ddr_test_dma(uintptr_t ddr_base_addr, size_t ddr_size, uint32_t tests, uint32_t seed,
+		       struct ddr_test_result *res);
+
+/* Generic timer ticks for one pass over the benchmark size */
+struct ddr_bench_cpu {
+	uint32_t read;
+	uint32_t write;
+	uint32_t copy;
+	uint32_t latency;	/* For 'loads' dependent loads */
+};
+
+/* DDR benchmark results, as returned by BOOTSTRAP_DDR_BENCH */
+struct ddr_bench {
+	uint32_t cntfrq;	/* Generic timer frequency */
+	uint32_t size;		/* Bytes per bandwidth pass */
+	uint32_t loads;		/* Latency pointer chase length */
+	struct ddr_bench_cpu nocache;
+	struct ddr_bench_cpu cache;
+	uint32_t dma_write;
+	uint32_t dma_copy;
+};
+
+void ddr_bench_cpu(uintptr_t ddr_base_addr, size_t size, struct ddr_bench *res,
+		   struct ddr_bench_cpu *cpu);
+void ddr_bench_dma(uintptr_t ddr_base_addr, size_t size, struct ddr_bench *res);
+
 #endif /* _DDR_TEST_H */
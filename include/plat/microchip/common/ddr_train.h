@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DDR_TRAIN_H
+#define _DDR_TRAIN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DDR_TRAIN_MAGIC		0x4e525444U	/* "DTRN" */
+#define DDR_TRAIN_MAX_REGS	48U
+
+/* Trained PHY delay registers, saved in flash between boots */
+struct ddr_train_record {
+	uint32_t magic;
+	uint32_t cfg_crc;	/* CRC32C of the DDR config trained with */
+	uint32_t nregs;
+	uint32_t regs[DDR_TRAIN_MAX_REGS];
+	uint32_t crc;		/* CRC32C of the above */
+};
+
+/* Only BL2 restores/saves, and only with a flash location */
+#if defined(MCHP_DDR_TRAIN_QSPI_OFFSET) && defined(IMAGE_BL2)
+#define DDR_TRAIN_CACHE		1
+bool ddr_train_load(uint32_t cfg_crc, uint32_t nregs, struct ddr_train_record *rec);
+void ddr_train_save(struct ddr_train_record *rec);
+#else
+#define DDR_TRAIN_CACHE		0
+static inline bool ddr_train_load(uint32_t cfg_crc, uint32_t nregs,
+				  struct ddr_train_record *rec)
+{
+	return false;
+}
+
+static inline void ddr_train_save(struct ddr_train_record *rec)
+{
+}
+#endif
+
+#endif /* _DDR_TRAIN_H */
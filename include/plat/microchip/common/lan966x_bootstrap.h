@@ -49,6 +49,12 @@
 #define BOOTSTRAP_DDR_CFG_GET  'c'
 // Perform DDR test (BL2U)
 #define BOOTSTRAP_DDR_TEST     'T'
+// DDR test arg0: bit 0 enables cache, bits 15:8 select DMA tests
+// (DDR_TEST_DMA_*), which then ACK with struct ddr_test_result
+#define BSTRAP_DDR_TEST_CACHE	BIT(0)
+#define BSTRAP_DDR_TEST_DMA(a)	(((a) >> 8) & 0xffU)
+// DDR benchmark, arg0 is MiB per pass (BL2U)
+#define BOOTSTRAP_DDR_BENCH    'M'
 // Get download data info (BL2U)
 #define BOOTSTRAP_DATA_HASH    'H'
 // Read register(s) (BL2U)
@@ -59,6 +65,10 @@
 #define BOOTSTRAP_WRITE_READBACK    'j'
 // Get SRAM block size (for BOOTSTRAP_SEND_SRAM cmd) (BL2U)
 #define BOOTSTRAP_SRAM_INFO    's'
+// Set up windowed DATA transfer (frame size), returns window size
+#define BOOTSTRAP_WINDOW       'w'
+// Streaming write of data to eMMC/SD/NOR while receiving (BL2U)
+#define BOOTSTRAP_STREAM_WRITE 'F'
 // ACK
 #define BOOTSTRAP_ACK          'a'
 // NACK
@@ -79,6 +89,15 @@ typedef struct {
 
 #define BSTRAP_REQ_FLAG_BINARY	BIT(0)
 
+/* Windowed DATA transfer: DATA frames outstanding per window */
+#define BSTRAP_WINDOW_FRAMES	16
+/* Windowed DATA transfer: Max DATA frame size */
+#define BSTRAP_WINDOW_MAX_FRAME	(64U * 1024U)
+/* Windowed DATA transfer: Max retransmits of a single window */
+#define BSTRAP_WINDOW_RETRIES	8
+/* Windowed DATA transfer: Max idle time on the line before NACK'ing */
+#define BSTRAP_WINDOW_TIMEOUT_US	(1000U * 1000U)
+
 typedef struct {
 	uint8_t  cmd;
 	uint8_t  flags;
@@ -87,6 +106,15 @@ typedef struct {
 	uint32_t crc;
 } bootstrap_req_t;
 
+/* Called with the length of contiguous data received, before the ACK */
+typedef void (*bootstrap_rx_hook_t)(uint32_t length);
+
+/* Bulk transmit of response data, replacing console_putc() per byte */
+typedef void (*bootstrap_tx_write_t)(const void *data, size_t length);
+
+/* Bulk receive of binary payload data, replacing console_getc() per byte */
+typedef size_t (*bootstrap_rx_read_t)(void *data, size_t length);
+
 static inline bool is_cmd(const bootstrap_req_t *req, const char cmd)
 {
 	return req->cmd == cmd;
@@ -132,3 +160,15 @@ static inline void bootstrap_TxNack(const char *str)
 }
 
 bool bootstrap_RxDataCrc(bootstrap_req_t *req, uint8_t *data);
+
+uint32_t bootstrap_SetWindow(uint32_t frame_size);
+
+bool bootstrap_WindowActive(void);
+
+int bootstrap_RxWindow(uint8_t *data, uint32_t length);
+
+void bootstrap_SetRxHook(bootstrap_rx_hook_t hook);
+
+void bootstrap_SetTxWrite(bootstrap_tx_write_t write);
+
+void bootstrap_SetRxRead(bootstrap_rx_read_t read);
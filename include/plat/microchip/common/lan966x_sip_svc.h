@@ -26,10 +26,11 @@
 #define SIP_SVC_GET_BOOT_OFF	0x8200ff0c
 #define SIP_SVC_SRAM_INFO	0x8200ff0d
 #define SIP_SVC_BL2_VERSION	0x8200ff0e
+#define SIP_SVC_BOOT_TRACE	0x8200ff0f
 
 /* SiP Service Calls version numbers */
 #define SIP_SVC_VERSION_MAJOR	0
-#define SIP_SVC_VERSION_MINOR	2
+#define SIP_SVC_VERSION_MINOR	3
 
 /* This is used as a signature to validate the encryption header */
 #define NS_ENC_HEADER_MAGIC		0xAA64BE05U
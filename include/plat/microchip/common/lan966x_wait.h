@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LAN966X_WAIT_H
+#define LAN966X_WAIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+struct lan966x_wait {
+	uint64_t timeout;	/* Deadline, in generic timer counts */
+	uint64_t spin;		/* Busy poll until, before sleeping */
+};
+
+/* Sleep until the next timer tick or deadline */
+typedef void (*lan966x_wait_sleep_t)(uint64_t deadline);
+
+void lan966x_wait_set_sleep(lan966x_wait_sleep_t sleep);
+
+void lan966x_wait_init(struct lan966x_wait *w, uint32_t timeout_us);
+bool lan966x_wait_timeout(struct lan966x_wait *w);
+
+#endif /* LAN966X_WAIT_H */
@@ -11,5 +11,7 @@
 
 void plat_lan966x_pinConfig(boot_source_type mode);
 void lan966x_mmc_plat_config(boot_source_type boot_source);
+size_t lan96xx_mmc_fip_prefetch(size_t offset, size_t max_len,
+				uintptr_t buf, size_t buf_size);
 
 #endif	/* LAN96XX_MMC_H */
@@ -8,6 +8,7 @@ LIBFDT_SRCS	:=	$(addprefix lib/libfdt/,	\
 			fdt.c				\
 			fdt_addresses.c			\
 			fdt_empty_tree.c		\
+			fdt_overlay.c			\
 			fdt_ro.c			\
 			fdt_rw.c			\
 			fdt_strerror.c			\
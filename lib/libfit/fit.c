@@ -12,6 +12,13 @@
 #include <arch_helpers.h>
 #include <lib/libfdt/libfdt.h>
 #include <lib/libfit/libfit.h>
+#include <lib/utils_def.h>
+#if defined(MCHP_LIBFIT_GZIP)
+#include <tf_gunzip.h>
+#endif
+#if defined(MCHP_LIBFIT_LZ4)
+#include <tf_lz4.h>
+#endif
 
 #include "fit.h"
 
@@ -29,12 +36,12 @@ int fit_plat_default_address(const struct fit_context *fit, fit_prop_t prop, uin
 	return -ENOENT;
 }
 
-#pragma weak fit_plat_uncompress
-int fit_plat_uncompress(const struct fit_context *fit, uintptr_t dst,
-			uintptr_t src, size_t src_len, size_t *out_len)
+#pragma weak fit_plat_hash
+int fit_plat_hash(const char *algo, uintptr_t dst, const void *src, size_t len,
+		  void *hash, size_t hash_len)
 {
-	/* No uncompress by default */
-	return -ENODEV;
+	/* No hash support by default */
+	return -ENOTSUP;
 }
 
 size_t fit_size(const struct fit_context *context)
@@ -42,6 +49,21 @@ size_t fit_size(const struct fit_context *context)
         return (size_t) fit_get_size(context->fit);
 }
 
+uintptr_t fit_scratch_end(const struct fit_context *context)
+{
+	uintptr_t end = (uintptr_t) context->fit + fit_size(context);
+
+#if defined(FIT_COMPRESSION)
+	/* Work area used when uncompressing, see fit_image_uncompress() */
+	end = round_up(end, FIT_COMP_ALIGN);
+#if defined(MCHP_LIBFIT_GZIP)
+	end = round_up(end + gunzip_work_size(), FIT_COMP_ALIGN);
+#endif
+#endif
+
+	return end;
+}
+
 static int fit_check_image_format(const void *fit)
 {
 	if (fdt_getprop(fit, 0, FITIMG_DESC_PROP_STR, NULL) == NULL) {
@@ -131,21 +153,27 @@ static int fit_conf_get_default_node(const void *fit)
 	return node_offset;
 }
 
-static int fit_image_check_comp(const void *fit, int node_offset, bool *compressed)
+static int fit_image_check_comp(const void *fit, int node_offset, fit_comp_t *comp)
 {
 	const char *val;
 
         /* Check compression property */
         val = (char *) fdt_getprop(fit, node_offset, FITIMG_COMP_PROP_STR, NULL);
         if (val == NULL || strcmp("none", val) == 0) {
-		*compressed = false;
+		*comp = FIT_COMP_NONE;
 		return 0;	/* No compression */
 	}
 #if defined(MCHP_LIBFIT_GZIP)
         if (strcmp("gzip", val) == 0) {
-		*compressed = true;
+		*comp = FIT_COMP_GZIP;
 		return 0;	/* GZIP compression */
 	}
+#endif
+#if defined(MCHP_LIBFIT_LZ4)
+        if (strcmp("lz4", val) == 0) {
+		*comp = FIT_COMP_LZ4;
+		return 0;	/* LZ4 compression */
+	}
 #endif
 	ERROR("fit: Compression '%s' is NOT supported\n", val);
 	return -EPROTONOSUPPORT;
@@ -166,6 +194,188 @@ static int fit_image_get_data(const void *fit, int node_offset,
 	return 0;
 }
 
+/*
+ * Verify the hash node(s) of a subimage. When 'dst' is set, the data is
+ * copied while it is hashed, and '*copied' tells if that was done.
+ */
+static int fit_image_verify(const void *fit, int node_offset, const char *prop_name,
+			    uintptr_t dst, const void *data, size_t size, bool *copied)
+{
+	uint8_t hash[MAX_FIT_HASH_SIZE];
+	const char *name, *algo;
+	const void *value;
+	int noffset, len, ret;
+
+	*copied = false;
+
+	fdt_for_each_subnode(noffset, fit, node_offset) {
+		name = fit_get_name(fit, noffset, NULL);
+		if (strncmp(name, FITIMG_HASH_NODENAME, strlen(FITIMG_HASH_NODENAME)) != 0)
+			continue;
+
+		algo = fdt_getprop(fit, noffset, FITIMG_ALGO_PROP_STR, NULL);
+		value = fdt_getprop(fit, noffset, FITIMG_VALUE_PROP_STR, &len);
+		if (algo == NULL || value == NULL || len > sizeof(hash)) {
+			ERROR("fit: %s has invalid '%s' node\n", prop_name, name);
+			return -EINVAL;
+		}
+
+		ret = fit_plat_hash(algo, *copied ? 0 : dst, data, size, hash, len);
+		if (ret == -ENOTSUP) {
+			INFO("fit: %s '%s' algo %s not supported, skipped\n",
+			     prop_name, name, algo);
+			continue;
+		}
+		if (ret != 0) {
+			ERROR("fit: %s '%s' error calculating %s: %d\n",
+			      prop_name, name, algo, ret);
+			return ret;
+		}
+
+		if (dst != 0)
+			*copied = true;
+
+		if (memcmp(hash, value, len) != 0) {
+			ERROR("fit: %s '%s' %s mismatch\n", prop_name, name, algo);
+			return -EBADMSG;
+		}
+
+		INFO("fit: %s '%s' %s OK\n", prop_name, name, algo);
+	}
+
+	return 0;
+}
+
+static bool fit_overlaps(uintptr_t a, size_t a_len, uintptr_t b, size_t b_len)
+{
+	return a < (b + b_len) && b < (a + a_len);
+}
+
+/* Check that a subimage leaves those already loaded alone */
+static int fit_check_loaded(const struct fit_context *context, fit_prop_t prop,
+			    uintptr_t start, size_t len)
+{
+	/* A loaded DT is grown in place by fit_fdt_update() */
+	if (prop != FITIMG_PROP_DT_TYPE && context->dtb != 0 &&
+	    fit_overlaps(start, len, context->dtb, MAX_FDT_SIZE))
+		return -EXDEV;
+
+	if (prop != FITIMG_PROP_RAMDISK_TYPE && context->initrd_size != 0 &&
+	    fit_overlaps(start, len, context->initrd, context->initrd_size))
+		return -EXDEV;
+
+	return 0;
+}
+
+#if defined(FIT_COMPRESSION)
+/*
+ * Decompress a subimage straight to its load address. Only when the
+ * output would overlap the FIT or the work area after it, decompress
+ * to a bounce area after those and move the result in place.
+ */
+static int fit_image_uncompress(const struct fit_context *context, fit_prop_t prop,
+				fit_comp_t comp, uintptr_t dst, const void *src,
+				size_t src_len, size_t *out_len)
+{
+	uintptr_t fit_start = (uintptr_t) context->fit;
+	uintptr_t fit_end = fit_start + fit_size(context);
+	uintptr_t in = (uintptr_t) src, out, out_start, work;
+	size_t len = 0, work_len = 0;
+	int ret;
+
+	work = round_up(fit_end, FIT_COMP_ALIGN);
+
+	switch (comp) {
+#if defined(MCHP_LIBFIT_GZIP)
+	case FIT_COMP_GZIP: {
+		const uint8_t *isize = (const uint8_t *) src + src_len - 4;
+
+		if (src_len < FIT_GZIP_MIN_SIZE)
+			return -EINVAL;
+
+		/* Uncompressed size is in the gzip trailer */
+		len = isize[0] | (isize[1] << 8) | (isize[2] << 16) | ((uint32_t) isize[3] << 24);
+
+		work_len = gunzip_work_size();
+		if (!fit_plat_is_ns_addr(work + work_len - 1))
+			return -ENOSPC;
+		/* The work area is clobbered, must spare a loaded DT/ramdisk */
+		ret = fit_check_loaded(context, prop, work, work_len);
+		if (ret)
+			return ret;
+		break;
+	}
+#endif
+#if defined(MCHP_LIBFIT_LZ4)
+	case FIT_COMP_LZ4:
+		/* No work area needed */
+		ret = unlz4_size(in, src_len, &len);
+		if (ret)
+			return ret;
+		break;
+#endif
+	default:
+		return -EPROTONOSUPPORT;
+	}
+
+	if (len == 0 || !fit_plat_is_ns_addr(dst + len - 1)) {
+		ERROR("fit: Only load to NS memory allowed: %p-%p\n",
+		      (void*) dst, (void*) (dst + len));
+		return -EACCES;
+	}
+
+	ret = fit_check_loaded(context, prop, dst, len);
+	if (ret)
+		return ret;
+
+	out_start = dst;
+	if (fit_overlaps(dst, len, fit_start, work + work_len - fit_start)) {
+		/* NB: Kernel allowed to overwrite - it's last */
+		if (prop != FITIMG_PROP_KERNEL_TYPE)
+			return -EXDEV;
+		out_start = round_up(work + work_len, FIT_COMP_ALIGN);
+		/* A ramdisk may already sit right after the work area */
+		if (context->initrd_size != 0 &&
+		    fit_overlaps(out_start, len, context->initrd, context->initrd_size))
+			out_start = round_up(context->initrd + context->initrd_size,
+					     FIT_COMP_ALIGN);
+		if (!fit_plat_is_ns_addr(out_start + len - 1) ||
+		    fit_check_loaded(context, prop, out_start, len) != 0)
+			return -ENOSPC;
+	}
+
+	VERBOSE("fit: Uncompress %p+%zd -> %p+%zd, work %p+%zd\n",
+		src, src_len, (void*) out_start, len, (void*) work, work_len);
+
+	out = out_start;
+	switch (comp) {
+#if defined(MCHP_LIBFIT_GZIP)
+	case FIT_COMP_GZIP:
+		ret = gunzip(&in, src_len, &out, len, work, work_len);
+		break;
+#endif
+#if defined(MCHP_LIBFIT_LZ4)
+	case FIT_COMP_LZ4:
+		ret = unlz4(&in, src_len, &out, len);
+		break;
+#endif
+	default:
+		ret = -EPROTONOSUPPORT;
+		break;
+	}
+	if (ret)
+		return ret;
+
+	*out_len = out - out_start;
+	if (out_start != dst) {
+		INFO("fit: Moving uncompressed data in place\n");
+		memmove((void*) dst, (void*) out_start, *out_len);
+	}
+
+	return 0;
+}
+#endif
+
 static int fit_image_get_address(const void *fit, int node_offset, char *name,
 			  uintptr_t *load)
 {
@@ -196,13 +406,14 @@ static int fit_image_get_address(const void *fit, int node_offset, char *name,
 	return fit_plat_is_ns_addr(*load) ? 0 : -EINVAL;
 }
 
-static int fit_image_get_load(const void *fit, fit_prop_t prop, int node_offset, uintptr_t *load)
+static int fit_image_get_load(const struct fit_context *context, fit_prop_t prop,
+			      int node_offset, uintptr_t *load)
 {
 	int ret;
 
-	ret = fit_image_get_address(fit, node_offset, FITIMG_LOAD_PROP_STR, load);
+	ret = fit_image_get_address(context->fit, node_offset, FITIMG_LOAD_PROP_STR, load);
 	if (ret) {
-		ret = fit_plat_default_address(fit, prop, load);
+		ret = fit_plat_default_address(context, prop, load);
 		if (ret == 0)
 			INFO("fit: Using default value of %p\n", (void*) *load);
 	}
@@ -279,17 +490,118 @@ const char *fit_property_2_str(fit_prop_t prop)
 	return NULL;
 }
 
+/*
+ * Find room for an overlay copy after the FIT, stepping past a loaded
+ * DT or ramdisk in the way. fdt_overlay_apply() needs an 8-byte
+ * aligned overlay, and modifies it.
+ */
+static int fit_overlay_scratch(const struct fit_context *context, size_t size,
+			       uintptr_t *addr)
+{
+	uintptr_t start = round_up(fit_scratch_end(context), FIT_OVERLAY_ALIGN);
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		if (context->dtb != 0 &&
+		    fit_overlaps(start, size, context->dtb, MAX_FDT_SIZE))
+			start = round_up(context->dtb + MAX_FDT_SIZE, FIT_OVERLAY_ALIGN);
+		if (context->initrd_size != 0 &&
+		    fit_overlaps(start, size, context->initrd, context->initrd_size))
+			start = round_up(context->initrd + context->initrd_size,
+					 FIT_OVERLAY_ALIGN);
+	}
+
+	if (!fit_plat_is_ns_addr(start + size - 1) ||
+	    fit_check_loaded(context, FITIMG_PROP_KERNEL_TYPE, start, size) != 0)
+		return -ENOSPC;
+
+	*addr = start;
+	return 0;
+}
+
+/*
+ * Apply the DT overlays following the base DT in the 'fdt' list of the
+ * config. This is done as part of loading the DT, as the kernel may
+ * overwrite the FIT later.
+ */
+static int fit_fdt_apply_overlays(struct fit_context *context)
+{
+	void *fdt = (void*) context->dtb;
+	fit_comp_t comp;
+	bool copied;
+	const void *data;
+	const char *name;
+	uintptr_t scratch;
+	size_t size;
+	int i, node_offset, ret;
+
+	for (i = 1; ; i++) {
+		node_offset = fit_conf_get_property_node_no(context->fit, context->cfg_node_offset,
+							    FITIMG_FDT_PROP_STR, i);
+		if (node_offset == -FDT_ERR_NOTFOUND)
+			break;	/* No more */
+		if (node_offset < 0)
+			return node_offset;
+
+		name = fit_get_name(context->fit, node_offset, NULL);
+
+		/* Overlays are applied from an aligned copy */
+		ret = fit_image_check_comp(context->fit, node_offset, &comp);
+		if (ret)
+			return ret;
+		if (comp != FIT_COMP_NONE) {
+			ERROR("fit: Compressed overlay '%s' not supported\n", name);
+			return -EPROTONOSUPPORT;
+		}
+
+		if (fit_image_get_data(context->fit, node_offset, &data, &size))
+			return -ENOENT;
+
+		ret = fit_overlay_scratch(context, size, &scratch);
+		if (ret) {
+			ERROR("fit: No room for overlay '%s'\n", name);
+			return ret;
+		}
+
+		ret = fit_image_verify(context->fit, node_offset, name, scratch, data, size, &copied);
+		if (ret)
+			return ret;
+		if (!copied)
+			memcpy((void*) scratch, data, size);
+
+		/* The base DT grows in place */
+		if (i == 1) {
+			if (fit_overlaps(context->dtb, MAX_FDT_SIZE,
+					 (uintptr_t) context->fit, fit_size(context)))
+				return -EXDEV;
+			ret = fdt_open_into(fdt, fdt, MAX_FDT_SIZE);
+			if (ret < 0)
+				return ret;
+		}
+
+		INFO("fit: Applying DT overlay '%s'\n", name);
+		ret = fdt_overlay_apply(fdt, (void*) scratch);
+		if (ret < 0) {
+			ERROR("fit: Overlay '%s' failed: %s\n", name, fdt_strerror(ret));
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 /*
  * Inspired by fit_extract_contents() form U-Boot
  */
 int fit_load(struct fit_context *context, fit_prop_t prop)
 {
-	bool compressed = false;
+	fit_comp_t comp = FIT_COMP_NONE;
+	bool compressed, copied;
 	const char *prop_name;
 	const void *buf;
 	int node_offset, ret;
 	size_t size;
-	uintptr_t load_start, load_end, image_start, image_end;
+	uintptr_t load_start, load_end, image_start, image_end, copy_dst;
 
 	/* Remember what we are working on */
 	prop_name = fit_property_2_str(prop);
@@ -298,13 +610,19 @@ int fit_load(struct fit_context *context, fit_prop_t prop)
 
 	node_offset = fit_conf_get_property_node(context->fit, context->cfg_node_offset, prop_name);
 	if (node_offset < 0) {
+		/* A ramdisk is optional */
+		if (prop == FITIMG_PROP_RAMDISK_TYPE) {
+			INFO("fit: No %s in '%s' config\n", prop_name, context->cfg);
+			return 0;
+		}
 		ERROR("fit: Could not find subimage node: %s\n", prop_name);
 		return -ENOENT;
 	}
 
 	/* Check compression */
-	if ((ret = fit_image_check_comp(context->fit, node_offset, &compressed)))
+	if ((ret = fit_image_check_comp(context->fit, node_offset, &comp)))
 		return ret;
+	compressed = comp != FIT_COMP_NONE;
 
 	/* get image data address and length */
 	if (fit_image_get_data(context->fit, node_offset, &buf, &size)) {
@@ -312,7 +630,7 @@ int fit_load(struct fit_context *context, fit_prop_t prop)
 		return -ENOENT;
 	}
 
-	ret = fit_image_get_load(context->fit, prop, node_offset, &load_start);
+	ret = fit_image_get_load(context, prop, node_offset, &load_start);
 	if (ret == 0) {
 		/* Check for overwriting */
 		image_start = (uintptr_t) buf;
@@ -327,6 +645,10 @@ int fit_load(struct fit_context *context, fit_prop_t prop)
 			/* NB: Kernel allowed to overwrite - it's last */
 			ERROR("fit: %s is overwriting FIT image\n", prop_name);
 			ret = -EXDEV;
+		} else if (!compressed &&
+			   fit_check_loaded(context, prop, load_start, size) != 0) {
+			ERROR("fit: %s is overwriting loaded subimage\n", prop_name);
+			ret = -EXDEV;
 		} else {
 			/* Special prop handling */
 			switch (prop) {
@@ -344,6 +666,9 @@ int fit_load(struct fit_context *context, fit_prop_t prop)
 			case FITIMG_PROP_DT_TYPE:
 				context->dtb = load_start;
 				break;
+			case FITIMG_PROP_RAMDISK_TYPE:
+				context->initrd = load_start;
+				break;
 			default:
 				break;
 			}
@@ -351,16 +676,40 @@ int fit_load(struct fit_context *context, fit_prop_t prop)
 			INFO("fit: Loading %s from %p to 0x%08lx, %zd bytes\n",
 			     prop_name, buf, load_start, size);
 
-			if (compressed) {
-				ret = fit_plat_uncompress(context, load_start, (uintptr_t) buf, size, &size);
+			/*
+			 * Hash the payload as stored. A plain copy is done
+			 * while hashing, unless it is overlapping.
+			 */
+			copy_dst = load_start;
+			if (compressed || (load_start < image_end && load_end > image_start))
+				copy_dst = 0;
+
+			ret = fit_image_verify(context->fit, node_offset, prop_name,
+					       copy_dst, buf, size, &copied);
+			if (ret == 0 && compressed) {
+#if defined(FIT_COMPRESSION)
+				ret = fit_image_uncompress(context, prop, comp, load_start,
+							   buf, size, &size);
+#else
+				ret = -EPROTONOSUPPORT;
+#endif
 				if (ret)
 					ERROR("fit: Error uncompressing %s: %d\n", prop_name, ret);
-				INFO("Uncompressed data to %zd bytes\n", size);
-			} else {
+				else
+					INFO("Uncompressed data to %zd bytes\n", size);
+			} else if (ret == 0 && !copied) {
 				/* Move the data in place */
 				memmove((void*) load_start, buf, size);
 			}
 
+			if (ret == 0 && prop == FITIMG_PROP_RAMDISK_TYPE)
+				context->initrd_size = size;
+
+			if (ret == 0 && prop == FITIMG_PROP_DT_TYPE) {
+				ret = fit_fdt_apply_overlays(context);
+				size = fdt_totalsize((void*) load_start);
+			}
+
 			/* We need to flush as we'll be in another CPU domain */
 			flush_dcache_range(load_start, size);
 		}
@@ -419,7 +768,7 @@ void fit_fdt_update(struct fit_context *context,
 		return;
 	}
 
-	if (bootargs) {
+	if (bootargs || context->initrd_size) {
 		int chosen;
 
 		chosen = fdt_add_subnode(fdt, 0, "chosen");
@@ -432,12 +781,24 @@ void fit_fdt_update(struct fit_context *context,
 			const void *existing = fdt_getprop(fdt, chosen, "bootargs", NULL);
 
 			/* Only set 'bootargs' if not already present */
-			if (existing == NULL) {
+			if (bootargs && existing == NULL) {
 				INFO("fit: Adding DT bootargs '%s'\n", bootargs);
 				ret = fdt_setprop_string(fdt, chosen, "bootargs", bootargs);
 				if (ret)
 					ERROR("fit: Could not set command line: %d\n", ret);
 			}
+
+			if (context->initrd_size) {
+				INFO("fit: Adding DT initrd %p-%p\n", (void*) context->initrd,
+				     (void*) (context->initrd + context->initrd_size));
+				ret = fdt_setprop_u64(fdt, chosen, "linux,initrd-start",
+						      context->initrd);
+				if (ret == 0)
+					ret = fdt_setprop_u64(fdt, chosen, "linux,initrd-end",
+							      context->initrd + context->initrd_size);
+				if (ret)
+					ERROR("fit: Could not set initrd: %d\n", ret);
+			}
 		}
 	}
 
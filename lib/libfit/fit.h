@@ -11,6 +11,9 @@
 #define FITIMG_COMP_PROP_STR		"compression"
 #define FITIMG_ENTRY_PROP_STR		"entry"
 #define FITIMG_LOAD_PROP_STR		"load"
+#define FITIMG_HASH_NODENAME		"hash"
+#define FITIMG_ALGO_PROP_STR		"algo"
+#define FITIMG_VALUE_PROP_STR		"value"
 
 #define FITIMG_KERNEL_PROP_STR		"kernel"
 #define FITIMG_RAMDISK_PROP_STR		"ramdisk"
@@ -18,6 +21,21 @@
 #define FITIMG_DEFAULT_PROP_STR		"default"
 
 #define MAX_FDT_SIZE		UL(128 * 1024) /* 128k */
+#define MAX_FIT_HASH_SIZE	64	/* sha512 */
+
+#define FIT_GZIP_MIN_SIZE	18	/* Header and trailer */
+#define FIT_COMP_ALIGN		UL(4096)
+#define FIT_OVERLAY_ALIGN	UL(8)
+
+#if defined(MCHP_LIBFIT_GZIP) || defined(MCHP_LIBFIT_LZ4)
+#define FIT_COMPRESSION
+#endif
+
+typedef enum {
+	FIT_COMP_NONE,
+	FIT_COMP_GZIP,
+	FIT_COMP_LZ4,
+} fit_comp_t;
 
 static inline const char *fit_get_name(const void *fit_hdr,
 				       int node_offset, int *len)
@@ -0,0 +1,9 @@
+#
+# Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+LZ4_SOURCES	:=	lib/lz4/tf_lz4.c
+
+INCLUDES	+=	-Iinclude/lib/lz4
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <tf_lz4.h>
+
+#define LZ4_FRAME_MAGIC		0x184D2204U
+#define LZ4_LEGACY_MAGIC	0x184C2102U
+#define LZ4_SKIP_MAGIC		0x184D2A50U	/* Low nibble is don't care */
+#define LZ4_SKIP_MASK		0xFFFFFFF0U
+
+#define LZ4_FLG_VERSION(f)	(((f) >> 6) & 3U)
+#define LZ4_FLG_BLOCK_CSUM	(1U << 4)
+#define LZ4_FLG_CONTENT_SIZE	(1U << 3)
+#define LZ4_FLG_CONTENT_CSUM	(1U << 2)
+#define LZ4_FLG_DICT_ID		(1U << 0)
+
+#define LZ4_BLOCK_UNCOMPRESSED	(1U << 31)
+#define LZ4_MIN_MATCH		4U
+
+/* Decoder position. With 'out' NULL only the output size is found */
+struct lz4_state {
+	const uint8_t *in;
+	const uint8_t *in_end;
+	uint8_t *out;
+	size_t out_pos;
+	size_t out_len;
+};
+
+static uint32_t lz4_get32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/* Extended literal or match length: a run of bytes, ended by one < 255 */
+static int lz4_get_len(const uint8_t **ip, const uint8_t *end, size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= end)
+			return -EIO;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255U);
+
+	return 0;
+}
+
+static int lz4_output(struct lz4_state *st, const uint8_t *src, size_t len)
+{
+	if (st->out != NULL) {
+		if (len > st->out_len - st->out_pos)
+			return -ENOSPC;
+		memcpy(st->out + st->out_pos, src, len);
+	}
+	st->out_pos += len;
+
+	return 0;
+}
+
+static int lz4_match(struct lz4_state *st, size_t offset, size_t len)
+{
+	uint8_t *dst, *src;
+
+	if (offset == 0U || offset > st->out_pos)
+		return -EIO;
+
+	if (st->out != NULL) {
+		if (len > st->out_len - st->out_pos)
+			return -ENOSPC;
+		dst = st->out + st->out_pos;
+		src = dst - offset;
+		if (offset >= len) {
+			memcpy(dst, src, len);
+		} else {
+			/* Overlapping match repeats the last 'offset' bytes */
+			size_t i;
+
+			for (i = 0; i < len; i++)
+				dst[i] = src[i];
+		}
+	}
+	st->out_pos += len;
+
+	return 0;
+}
+
+static int lz4_block(struct lz4_state *st, const uint8_t *ip, size_t len)
+{
+	const uint8_t *end = ip + len;
+	size_t lit, match, offset;
+	uint8_t token;
+	int ret;
+
+	while (ip < end) {
+		token = *ip++;
+
+		lit = token >> 4;
+		if (lit == 15U && lz4_get_len(&ip, end, &lit) != 0)
+			return -EIO;
+		if (lit > (size_t) (end - ip))
+			return -EIO;
+		ret = lz4_output(st, ip, lit);
+		if (ret != 0)
+			return ret;
+		ip += lit;
+
+		/* The last sequence is literals only */
+		if (ip == end)
+			break;
+
+		if ((end - ip) < 2)
+			return -EIO;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		match = token & 15U;
+		if (match == 15U && lz4_get_len(&ip, end, &match) != 0)
+			return -EIO;
+		ret = lz4_match(st, offset, match + LZ4_MIN_MATCH);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int lz4_frame(struct lz4_state *st)
+{
+	const uint8_t *ip = st->in + 4;
+	uint32_t flg, bsize;
+	size_t hdr_len = 3;	/* FLG, BD and header checksum */
+	int ret;
+
+	if ((st->in_end - ip) < (ptrdiff_t) hdr_len)
+		return -EIO;
+
+	flg = ip[0];
+	if (LZ4_FLG_VERSION(flg) != 1U || (flg & LZ4_FLG_DICT_ID)) {
+		ERROR("lz4: Unsupported frame flags %02x\n", flg);
+		return -ENOTSUP;
+	}
+	if (flg & LZ4_FLG_CONTENT_SIZE)
+		hdr_len += 8;
+
+	/* NB: Header, block and content checksums are not checked */
+	ip += hdr_len;
+
+	for (;;) {
+		if ((st->in_end - ip) < 4)
+			return -EIO;
+		bsize = lz4_get32(ip);
+		ip += 4;
+
+		if (bsize == 0U)
+			break;	/* EndMark */
+
+		if ((bsize & ~LZ4_BLOCK_UNCOMPRESSED) > (size_t) (st->in_end - ip))
+			return -EIO;
+
+		if (bsize & LZ4_BLOCK_UNCOMPRESSED) {
+			bsize &= ~LZ4_BLOCK_UNCOMPRESSED;
+			ret = lz4_output(st, ip, bsize);
+		} else {
+			ret = lz4_block(st, ip, bsize);
+		}
+		if (ret != 0)
+			return ret;
+		ip += bsize;
+
+		if (flg & LZ4_FLG_BLOCK_CSUM)
+			ip += 4;
+	}
+
+	if (flg & LZ4_FLG_CONTENT_CSUM)
+		ip += 4;
+
+	if (ip > st->in_end)
+		return -EIO;
+
+	st->in = ip;
+
+	return 0;
+}
+
+/* Legacy frames, as used for Linux kernel images */
+static int lz4_legacy(struct lz4_state *st)
+{
+	const uint8_t *ip = st->in + 4;
+	uint32_t bsize;
+	int ret;
+
+	/* Blocks until end of input or the next frame. A size may trail */
+	while ((st->in_end - ip) > 4) {
+		bsize = lz4_get32(ip);
+		if (bsize == LZ4_LEGACY_MAGIC || bsize == LZ4_FRAME_MAGIC)
+			break;
+		ip += 4;
+
+		if (bsize > (size_t) (st->in_end - ip))
+			return -EIO;
+
+		ret = lz4_block(st, ip, bsize);
+		if (ret != 0)
+			return ret;
+		ip += bsize;
+	}
+
+	st->in = ((st->in_end - ip) > 4) ? ip : st->in_end;
+
+	return 0;
+}
+
+static int lz4_run(struct lz4_state *st)
+{
+	uint32_t magic;
+	int ret;
+
+	while ((st->in_end - st->in) >= 4) {
+		magic = lz4_get32(st->in);
+
+		if (magic == LZ4_FRAME_MAGIC) {
+			ret = lz4_frame(st);
+		} else if (magic == LZ4_LEGACY_MAGIC) {
+			ret = lz4_legacy(st);
+		} else if ((magic & LZ4_SKIP_MASK) == LZ4_SKIP_MAGIC &&
+			   (st->in_end - st->in) >= 8 &&
+			   lz4_get32(st->in + 4) <= (size_t) (st->in_end - st->in - 8)) {
+			st->in += 8 + lz4_get32(st->in + 4);
+			ret = 0;
+		} else {
+			/* Trailing garbage after the last frame is ignored */
+			break;
+		}
+
+		if (ret != 0) {
+			ERROR("lz4: Decompression failed (ret = %d)\n", ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+bool is_lz4(const void *buf, size_t len)
+{
+	uint32_t magic;
+
+	if (len < 4)
+		return false;
+
+	magic = lz4_get32(buf);
+
+	return magic == LZ4_FRAME_MAGIC || magic == LZ4_LEGACY_MAGIC;
+}
+
+/*
+ * unlz4_size - find the decompressed size of lz4 data
+ * @in_buf: source of compressed input
+ * @in_len: length of in_buf
+ * @out_len: upon success, the decompressed length
+ *
+ * The sequences are walked without producing output, which is cheap
+ * compared to decompressing.
+ */
+int unlz4_size(uintptr_t in_buf, size_t in_len, size_t *out_len)
+{
+	struct lz4_state st = {
+		.in = (const uint8_t *) in_buf,
+		.in_end = (const uint8_t *) in_buf + in_len,
+	};
+	int ret;
+
+	if (!is_lz4((const void *) in_buf, in_len))
+		return -EINVAL;
+
+	ret = lz4_run(&st);
+	if (ret == 0)
+		*out_len = st.out_pos;
+
+	return ret;
+}
+
+/*
+ * unlz4 - decompress lz4 frame or legacy format data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ */
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len)
+{
+	struct lz4_state st = {
+		.in = (const uint8_t *) *in_buf,
+		.in_end = (const uint8_t *) *in_buf + in_len,
+		.out = (uint8_t *) *out_buf,
+		.out_len = out_len,
+	};
+	int ret;
+
+	if (!is_lz4((const void *) *in_buf, in_len))
+		return -EINVAL;
+
+	ret = lz4_run(&st);
+
+	VERBOSE("lz4: %zu byte input\n", (size_t) (st.in - (const uint8_t *) *in_buf));
+	VERBOSE("lz4: %zu byte output\n", st.out_pos);
+
+	*in_buf = (uintptr_t) st.in;
+	*out_buf += st.out_pos;
+
+	return ret;
+}
@@ -14,6 +14,8 @@
 #include <tf_gunzip.h>
 
 #include "zutil.h"
+#include "inftrees.h"
+#include "inflate.h"
 
 /*
  * memory allocated by malloc() is supposed to be aligned for any built-in type
@@ -48,6 +50,18 @@ static void ZLIB_INTERNAL zfree(void *opaque, void *ptr)
 {
 }
 
+/*
+ * gunzip_work_size - workspace needed by gunzip()
+ *
+ * Return the size of the inflate state and the sliding window, which
+ * is all the inflater allocates.
+ */
+size_t gunzip_work_size(void)
+{
+	return round_up(sizeof(struct inflate_state), ZALLOC_ALIGNMENT) +
+		(1U << (DEF_WBITS & 15)) + ZALLOC_ALIGNMENT;
+}
+
 /*
  * gunzip - decompress gzip data
  * @in_buf: source of compressed input. Upon exit, the end of input.
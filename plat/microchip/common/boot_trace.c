@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/utils_def.h>
+#include <platform_def.h>
+
+#include <boot_trace.h>
+
+static struct boot_trace trace __aligned(CACHE_WRITEBACK_GRANULE);
+
+void boot_trace(boot_trace_event_t event, uint32_t arg)
+{
+	struct boot_trace_rec *rec;
+
+	if (trace.magic != BOOT_TRACE_MAGIC) {
+		trace.magic = BOOT_TRACE_MAGIC;
+		trace.count = 0;
+	}
+
+	/* Boot is over, keep runtime services from evicting its records */
+	if (trace.count != 0 &&
+	    trace.rec[(trace.count - 1) % BOOT_TRACE_ENTRIES].event == BOOT_TRACE_BL33_START)
+		return;
+
+	rec = &trace.rec[trace.count % BOOT_TRACE_ENTRIES];
+	rec->event = event;
+	rec->arg = arg;
+	rec->cntpct = read_cntpct_el0();
+	trace.count++;
+}
+
+/* Address of the ring to pass on to the next stage */
+uintptr_t boot_trace_handoff(void)
+{
+	if (trace.magic != BOOT_TRACE_MAGIC)
+		return 0;
+
+	/* Passed between contexts */
+	flush_dcache_range((uintptr_t) &trace, sizeof(trace));
+
+	return (uintptr_t) &trace;
+}
+
+/*
+ * Take over the ring of the previous stage. The address comes from
+ * older (ROM) code as well, so only accept it within the memory of
+ * that stage. Must be called before recording anything.
+ */
+void boot_trace_inherit(uintptr_t prev, uintptr_t base, uintptr_t limit)
+{
+	const struct boot_trace *src = (const struct boot_trace *) prev;
+
+	if (prev == 0U || (prev % sizeof(uint64_t)) != 0U ||
+	    prev < base || limit < sizeof(*src) || prev > (limit - sizeof(*src)))
+		return;
+
+	if (src->magic != BOOT_TRACE_MAGIC)
+		return;
+
+	memcpy(&trace, src, sizeof(trace));
+	VERBOSE("Boot trace: %d events inherited\n", trace.count);
+}
+
+/* Copy out the recorded events, oldest first */
+size_t boot_trace_export(struct boot_trace_rec *buf, size_t nrec)
+{
+	uint32_t first, avail, i;
+
+	if (trace.magic != BOOT_TRACE_MAGIC)
+		return 0;
+
+	avail = MIN(trace.count, BOOT_TRACE_ENTRIES);
+	first = trace.count - avail;
+	nrec = MIN(nrec, (size_t) avail);
+
+	for (i = 0; i < nrec; i++)
+		buf[i] = trace.rec[(first + i) % BOOT_TRACE_ENTRIES];
+
+	return nrec;
+}
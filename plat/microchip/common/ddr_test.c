@@ -4,11 +4,18 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
+#include <string.h>
+
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include <ddr_init.h>
 #include <ddr_test.h>
+#include <drivers/auth/crypto_mod.h>
+#include <drivers/microchip/sha.h>
+#include <drivers/microchip/xdmac.h>
 #include <lib/mmio.h>
+#include <lib/utils_def.h>
 #include <platform_def.h>
 
 #define DDR_PATTERN1 0xAAAAAAAAU
@@ -162,3 +169,502 @@ uintptr_t ddr_test_rnd(uintptr_t ddr_base_addr, size_t ddr_size, bool cache, uin
 
 	return 0;
 }
+
+/*
+ * DMA test engine. Each pattern is a tile repeated over a chunk. Chunks
+ * are filled by the XDMAC and verified by hashing them with the SHA
+ * engine, only falling back to the CPU to pinpoint a failing word.
+ * March elements that read and write each cell are run word by word
+ * by the CPU, a chunk is too coarse a cell for those.
+ */
+#define DDR_TEST_TILE_SIZE	SIZE_K(4)
+#define DDR_TEST_CHUNK_SIZE	SIZE_M(1)
+#define DDR_TEST_HASH		SHA_MR_ALGO_SHA256
+#define DDR_TEST_HASH_LEN	32U
+
+enum {
+	PAT_NONE,
+	PAT_ZERO,
+	PAT_ONES,
+	PAT_WALK1,
+	PAT_CHECKER,
+	PAT_CHECKER_INV,
+	PAT_RND,	/* New random tile per chunk */
+	PAT_COUNT,
+};
+
+/*
+ * March element: For each chunk, verify 'rd' then write 'wr'. If 'word',
+ * do so for each word in turn instead - only PAT_ZERO and PAT_ONES.
+ */
+struct ddr_test_elem {
+	bool down;
+	bool word;
+	uint8_t rd;
+	uint8_t wr;
+};
+
+static const struct ddr_test_elem test_rnd[] = {
+	{ false, false, PAT_NONE, PAT_RND },
+	{ false, false, PAT_RND, PAT_NONE },
+};
+
+static const struct ddr_test_elem test_walk1[] = {
+	{ false, false, PAT_NONE, PAT_WALK1 },
+	{ false, false, PAT_WALK1, PAT_NONE },
+};
+
+static const struct ddr_test_elem test_checker[] = {
+	{ false, false, PAT_NONE, PAT_CHECKER },
+	{ false, false, PAT_CHECKER, PAT_CHECKER_INV },
+	{ false, false, PAT_CHECKER_INV, PAT_NONE },
+};
+
+/* March C-, the plain w0 and r0 elements are done by DMA */
+static const struct ddr_test_elem test_march[] = {
+	{ false, false, PAT_NONE, PAT_ZERO },
+	{ false, true,  PAT_ZERO, PAT_ONES },
+	{ false, true,  PAT_ONES, PAT_ZERO },
+	{ true,  true,  PAT_ZERO, PAT_ONES },
+	{ true,  true,  PAT_ONES, PAT_ZERO },
+	{ false, false, PAT_ZERO, PAT_NONE },
+};
+
+static const struct {
+	uint32_t id;
+	const char *name;
+	const struct ddr_test_elem *elem;
+	size_t nelem;
+} ddr_dma_tests[DDR_TEST_DMA_TESTS] = {
+	{ DDR_TEST_DMA_RND, "random", test_rnd, ARRAY_SIZE(test_rnd) },
+	{ DDR_TEST_DMA_WALK1, "walking ones", test_walk1, ARRAY_SIZE(test_walk1) },
+	{ DDR_TEST_DMA_CHECKER, "checkerboard", test_checker, ARRAY_SIZE(test_checker) },
+	{ DDR_TEST_DMA_MARCH, "March C-", test_march, ARRAY_SIZE(test_march) },
+};
+
+static struct ddr_test_ctx {
+	uintptr_t base;
+	size_t size;
+	size_t region_size;
+	uint32_t seed;
+	uint64_t ticks[DDR_TEST_REGIONS];
+	/* Current tile */
+	int pat;
+	uint32_t pat_seed;
+	/* Expected chunk hashes, all but PAT_RND are fixed */
+	uint8_t hash[PAT_COUNT][DDR_TEST_HASH_LEN];
+	bool hash_valid[PAT_COUNT];
+} ctx;
+
+static uint32_t tile[DDR_TEST_TILE_SIZE / sizeof(uint32_t)] __aligned(CACHE_WRITEBACK_GRANULE);
+
+static void ddr_test_tile(int pat, uint32_t seed)
+{
+	uint32_t value = seed;
+	size_t i;
+
+	if (pat == ctx.pat && seed == ctx.pat_seed)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(tile); i++) {
+		switch (pat) {
+		case PAT_ZERO:
+			tile[i] = 0;
+			break;
+		case PAT_ONES:
+			tile[i] = ~0U;
+			break;
+		case PAT_WALK1:
+			tile[i] = BIT_32(i % 32U);
+			break;
+		case PAT_CHECKER:
+			tile[i] = (i & 1U) ? DDR_PATTERN2 : DDR_PATTERN1;
+			break;
+		case PAT_CHECKER_INV:
+			tile[i] = (i & 1U) ? DDR_PATTERN1 : DDR_PATTERN2;
+			break;
+		default:
+			value = ps_rnd(value);
+			tile[i] = value;
+			break;
+		}
+	}
+
+	ctx.pat = pat;
+	ctx.pat_seed = seed;
+}
+
+/* Set up the tile for a chunk */
+static void ddr_test_chunk_tile(int pat, uintptr_t chunk)
+{
+	uint32_t seed = 0;
+
+	if (pat == PAT_RND)
+		seed = ps_rnd(ctx.seed ^ (uint32_t) (chunk - ctx.base));
+
+	ddr_test_tile(pat, seed);
+}
+
+/* Set up the tile for a chunk, returns the expected chunk hash */
+static const uint8_t *ddr_test_chunk_hash(int pat, uintptr_t chunk)
+{
+	size_t off;
+	void *st;
+
+	ddr_test_chunk_tile(pat, chunk);
+
+	if (ctx.hash_valid[pat])
+		return ctx.hash[pat];
+
+	/* Hash the tile as often as it repeats in a chunk */
+	st = sha_calc_init(DDR_TEST_HASH, DDR_TEST_CHUNK_SIZE, DDR_TEST_HASH_LEN);
+	if (st == NULL)
+		return NULL;
+	for (off = 0; off < DDR_TEST_CHUNK_SIZE; off += DDR_TEST_TILE_SIZE)
+		sha_update(st, tile, sizeof(tile));
+	if (sha_calc_finish(st, ctx.hash[pat]) != 0)
+		return NULL;
+
+	ctx.hash_valid[pat] = (pat != PAT_RND);
+
+	return ctx.hash[pat];
+}
+
+static void ddr_test_chunk_fill(uintptr_t chunk, int pat)
+{
+	size_t len;
+
+	if (pat == PAT_ZERO) {
+		xdmac_bzero((void *) chunk, DDR_TEST_CHUNK_SIZE);
+		return;
+	}
+
+	ddr_test_chunk_tile(pat, chunk);
+
+	/* One tile, then double up what is already there */
+	xdmac_memcpy((void *) chunk, tile, sizeof(tile),
+		     XDMA_DIR_MEM_TO_MEM, XDMA_NONE);
+	for (len = sizeof(tile); len < DDR_TEST_CHUNK_SIZE; len <<= 1)
+		xdmac_memcpy((void *) (chunk + len), (void *) chunk, len,
+			     XDMA_DIR_MEM_TO_MEM, XDMA_NONE);
+}
+
+static uintptr_t ddr_test_chunk_check(uintptr_t chunk, int pat)
+{
+	const uint8_t *hash = ddr_test_chunk_hash(pat, chunk);
+	size_t offset;
+	uint32_t w;
+
+	if (hash == NULL) {
+		ERROR("DDR TEST: Hash failed\n");
+		return chunk;
+	}
+
+	if (sha_verify(DDR_TEST_HASH, (void *) chunk, DDR_TEST_CHUNK_SIZE,
+		       hash, DDR_TEST_HASH_LEN) == CRYPTO_SUCCESS)
+		return 0;
+
+	/* Find the culprit */
+	inv_dcache_range(chunk, DDR_TEST_CHUNK_SIZE);
+	for (offset = 0; offset < DDR_TEST_CHUNK_SIZE; offset += sizeof(uint32_t)) {
+		uint32_t exp = tile[(offset % sizeof(tile)) / sizeof(uint32_t)];
+
+		w = mmio_read_32(chunk + offset);
+		if (w != exp) {
+			ERROR("DDR TEST: RD(%08lx): %08x != %08x\n",
+			      chunk + offset, w, exp);
+			return chunk + offset;
+		}
+	}
+
+	ERROR("DDR TEST: Hash mismatch @ %08lx, data reads back ok\n", chunk);
+
+	return chunk;
+}
+
+/* Verify 'rd' then write 'wr' one word at a time, in element order */
+static uintptr_t ddr_test_chunk_march(uintptr_t chunk, const struct ddr_test_elem *elem)
+{
+	size_t nwords = DDR_TEST_CHUNK_SIZE / sizeof(uint32_t);
+	uint32_t rd = elem->rd == PAT_ONES ? ~0U : 0U;
+	uint32_t wr = elem->wr == PAT_ONES ? ~0U : 0U;
+	uintptr_t addr;
+	uint32_t w;
+	size_t i;
+
+	assert(elem->rd == PAT_ZERO || elem->rd == PAT_ONES);
+	assert(elem->wr == PAT_ZERO || elem->wr == PAT_ONES);
+
+	inv_dcache_range(chunk, DDR_TEST_CHUNK_SIZE);
+
+	for (i = 0; i < nwords; i++) {
+		addr = chunk + sizeof(uint32_t) * (elem->down ? (nwords - 1 - i) : i);
+		w = mmio_read_32(addr);
+		if (w != rd) {
+			ERROR("DDR TEST: RD(%08lx): %08x != %08x\n", addr, w, rd);
+			return addr;
+		}
+		mmio_write_32(addr, wr);
+	}
+
+	/* Later elements verify by DMA */
+	flush_dcache_range(chunk, DDR_TEST_CHUNK_SIZE);
+
+	return 0;
+}
+
+static uintptr_t ddr_test_element(const struct ddr_test_elem *elem)
+{
+	size_t nchunks = ctx.size / DDR_TEST_CHUNK_SIZE;
+	uintptr_t chunk, err;
+	uint64_t start;
+	size_t i;
+
+	for (i = 0; i < nchunks; i++) {
+		chunk = ctx.base + DDR_TEST_CHUNK_SIZE *
+			(elem->down ? (nchunks - 1 - i) : i);
+		start = read_cntpct_el0();
+
+		if (elem->word) {
+			err = ddr_test_chunk_march(chunk, elem);
+			if (err != 0)
+				return err;
+		} else if (elem->rd != PAT_NONE) {
+			err = ddr_test_chunk_check(chunk, elem->rd);
+			if (err != 0)
+				return err;
+		}
+
+		if (!elem->word && elem->wr != PAT_NONE)
+			ddr_test_chunk_fill(chunk, elem->wr);
+
+		ctx.ticks[(chunk - ctx.base) / ctx.region_size] +=
+			read_cntpct_el0() - start;
+	}
+
+	return 0;
+}
+
+static unsigned int ddr_test_ms(uint64_t ticks)
+{
+	return (unsigned int) ((ticks * 1000U) / read_cntfrq_el0());
+}
+
+/*******************************************************************************
+ * This function runs the selected DDR_TEST_DMA_* tests on [ddr_base_addr,
+ * ddr_base_addr + ddr_size), which must be a whole number of MiB. The
+ * time spent is reported per region in 'res'.
+ * Returns 0 if success, and address value else.
+ ******************************************************************************/
+uintptr_t ddr_test_dma(uintptr_t ddr_base_addr, size_t ddr_size, uint32_t tests, uint32_t seed,
+		       struct ddr_test_result *res)
+{
+	uintptr_t err;
+	uint64_t total;
+	size_t i, j;
+
+	ctx.base = ddr_base_addr;
+	ctx.size = ddr_size - (ddr_size % DDR_TEST_CHUNK_SIZE);
+	ctx.region_size = round_up(div_round_up(ctx.size, DDR_TEST_REGIONS),
+				   DDR_TEST_CHUNK_SIZE);
+	ctx.seed = seed;
+	ctx.pat = PAT_NONE;
+	for (i = 0; i < PAT_COUNT; i++)
+		ctx.hash_valid[i] = false;
+
+	memset(res, 0, sizeof(*res));
+	res->region_size = (uint32_t) ctx.region_size;
+
+	for (i = 0; i < ARRAY_SIZE(ddr_dma_tests); i++) {
+		if ((tests & ddr_dma_tests[i].id) == 0U)
+			continue;
+
+		INFO("DDR %s test begin, start %08lx, size 0x%08zx\n",
+		     ddr_dma_tests[i].name, ctx.base, ctx.size);
+
+		for (j = 0; j < DDR_TEST_REGIONS; j++)
+			ctx.ticks[j] = 0;
+
+		for (j = 0; j < ddr_dma_tests[i].nelem; j++) {
+			err = ddr_test_element(&ddr_dma_tests[i].elem[j]);
+			if (err != 0)
+				return err;
+		}
+
+		for (j = 0, total = 0; j < DDR_TEST_REGIONS; j++) {
+			uintptr_t start = ctx.base + j * ctx.region_size;
+
+			if (j * ctx.region_size >= ctx.size)
+				break;
+			res->ms[i][j] = ddr_test_ms(ctx.ticks[j]);
+			NOTICE("DDR %s: %08lx-%08lx: %u ms\n", ddr_dma_tests[i].name,
+			       start, start + MIN(ctx.region_size, ctx.size - j * ctx.region_size) - 1,
+			       res->ms[i][j]);
+			total += ctx.ticks[j];
+		}
+		NOTICE("DDR %s: %zu MiB in %u ms\n", ddr_dma_tests[i].name,
+		       ctx.size / (size_t) SIZE_M(1), ddr_test_ms(total));
+	}
+
+	return 0;
+}
+
+/*
+ * DDR benchmark. Bandwidth passes use [ddr_base_addr, + size), copies go
+ * to [+ size, + 2 * size). Results are generic timer ticks.
+ */
+#define DDR_BENCH_STRIDE	CACHE_WRITEBACK_GRANULE	/* Latency: one load per line */
+#define DDR_BENCH_MAX_LOADS	SIZE_M(1)
+
+static uint32_t ddr_bench_ticks(uint64_t start)
+{
+	return (uint32_t) (read_cntpct_el0() - start);
+}
+
+static uint32_t ddr_bench_read(uintptr_t base, size_t size)
+{
+	const u_register_t *p = (const u_register_t *) base;
+	const u_register_t *end = (const u_register_t *) (base + size);
+	u_register_t sum = 0;
+	uint64_t start;
+
+	inv_dcache_range(base, size);
+
+	start = read_cntpct_el0();
+	for (; p < end; p += 4)
+		sum ^= p[0] ^ p[1] ^ p[2] ^ p[3];
+	dsbsy();
+
+	/* Keep the loads */
+	*(volatile u_register_t *) base = sum;
+
+	return ddr_bench_ticks(start);
+}
+
+static uint32_t ddr_bench_write(uintptr_t base, size_t size)
+{
+	u_register_t *p = (u_register_t *) base;
+	u_register_t *end = (u_register_t *) (base + size);
+	uint64_t start;
+
+	inv_dcache_range(base, size);
+
+	start = read_cntpct_el0();
+	for (; p < end; p += 4) {
+		p[0] = (u_register_t) DDR_PATTERN1;
+		p[1] = (u_register_t) DDR_PATTERN2;
+		p[2] = (u_register_t) DDR_PATTERN1;
+		p[3] = (u_register_t) DDR_PATTERN2;
+	}
+	/* Until written back */
+	flush_dcache_range(base, size);
+
+	return ddr_bench_ticks(start);
+}
+
+static uint32_t ddr_bench_copy(uintptr_t dst, uintptr_t src, size_t size)
+{
+	u_register_t *d = (u_register_t *) dst;
+	const u_register_t *p = (const u_register_t *) src;
+	const u_register_t *end = (const u_register_t *) (src + size);
+	uint64_t start;
+
+	inv_dcache_range(src, size);
+	inv_dcache_range(dst, size);
+
+	start = read_cntpct_el0();
+	for (; p < end; p += 4, d += 4) {
+		d[0] = p[0];
+		d[1] = p[1];
+		d[2] = p[2];
+		d[3] = p[3];
+	}
+	flush_dcache_range(dst, size);
+
+	return ddr_bench_ticks(start);
+}
+
+/*
+ * Chase pointers through one line at a time in random order, so each
+ * load waits for the previous one. The chain is a single random cycle
+ * (Sattolo), so no line is visited twice.
+ */
+static uint32_t ddr_bench_latency(uintptr_t base, size_t size, uint32_t loads)
+{
+	size_t n = size / DDR_BENCH_STRIDE;
+	uintptr_t slot, p;
+	unsigned int rnd = 0xdeadbeef;
+	size_t i, j, tmp;
+	uint64_t start;
+
+	for (i = 0; i < n; i++)
+		*(volatile uintptr_t *) (base + i * DDR_BENCH_STRIDE) = i;
+
+	for (i = n - 1; i > 0; i--) {
+		rnd = ps_rnd(rnd);
+		j = rnd % i;
+		slot = base + i * DDR_BENCH_STRIDE;
+		tmp = *(volatile uintptr_t *) slot;
+		*(volatile uintptr_t *) slot = *(volatile uintptr_t *) (base + j * DDR_BENCH_STRIDE);
+		*(volatile uintptr_t *) (base + j * DDR_BENCH_STRIDE) = tmp;
+	}
+
+	/* Index to address */
+	for (i = 0; i < n; i++) {
+		slot = base + i * DDR_BENCH_STRIDE;
+		*(volatile uintptr_t *) slot = base + *(volatile uintptr_t *) slot * DDR_BENCH_STRIDE;
+	}
+
+	/* Start out of cache */
+	flush_dcache_range(base, size);
+
+	p = base;
+	start = read_cntpct_el0();
+	for (i = 0; i < loads; i++)
+		p = *(volatile uintptr_t *) p;
+
+	/* Keep the loads */
+	*(volatile uintptr_t *) base = p;
+
+	return ddr_bench_ticks(start);
+}
+
+/*******************************************************************************
+ * This function measures CPU bandwidth and latency with the current
+ * cache setting. Needs 2 * size bytes of DDR.
+ ******************************************************************************/
+void ddr_bench_cpu(uintptr_t ddr_base_addr, size_t size, struct ddr_bench *res,
+		   struct ddr_bench_cpu *cpu)
+{
+	res->cntfrq = (uint32_t) read_cntfrq_el0();
+	res->size = (uint32_t) size;
+	res->loads = (uint32_t) MIN(size / DDR_BENCH_STRIDE, (size_t) DDR_BENCH_MAX_LOADS);
+
+	cpu->write = ddr_bench_write(ddr_base_addr, size);
+	cpu->read = ddr_bench_read(ddr_base_addr, size);
+	cpu->copy = ddr_bench_copy(ddr_base_addr + size, ddr_base_addr, size);
+	cpu->latency = ddr_bench_latency(ddr_base_addr, size, res->loads);
+
+	INFO("DDR bench: wr %u rd %u cp %u lat %u ticks\n",
+	     cpu->write, cpu->read, cpu->copy, cpu->latency);
+}
+
+/*******************************************************************************
+ * This function measures XDMAC memset and copy bandwidth. Needs 2 * size
+ * bytes of DDR.
+ ******************************************************************************/
+void ddr_bench_dma(uintptr_t ddr_base_addr, size_t size, struct ddr_bench *res)
+{
+	uint64_t start;
+
+	start = read_cntpct_el0();
+	xdmac_bzero((void *) ddr_base_addr, size);
+	res->dma_write = ddr_bench_ticks(start);
+
+	start = read_cntpct_el0();
+	xdmac_memcpy((void *) (ddr_base_addr + size), (void *) ddr_base_addr, size,
+		     XDMA_DIR_MEM_TO_MEM, XDMA_NONE);
+	res->dma_copy = ddr_bench_ticks(start);
+
+	INFO("DDR bench: dma wr %u cp %u ticks\n", res->dma_write, res->dma_copy);
+}
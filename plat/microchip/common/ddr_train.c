@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <drivers/microchip/qspi.h>
+#include <platform_def.h>
+
+#include <ddr_train.h>
+#include <lan966x_crc32.h>
+#include <lan96xx_common.h>
+
+/* QSPI reads may use DMA */
+static struct ddr_train_record train_rec __aligned(CACHE_WRITEBACK_GRANULE);
+
+static uint32_t ddr_train_crc(const struct ddr_train_record *rec)
+{
+	return Crc32c(0, rec, offsetof(struct ddr_train_record, crc));
+}
+
+/* The record is kept in a reserved NOR sector, only when booting from it */
+static bool ddr_train_available(void)
+{
+	return lan966x_get_boot_source() == BOOT_SOURCE_QSPI;
+}
+
+bool ddr_train_load(uint32_t cfg_crc, uint32_t nregs, struct ddr_train_record *rec)
+{
+	size_t act_read;
+
+	if (!ddr_train_available())
+		return false;
+
+	if (qspi_read(MCHP_DDR_TRAIN_QSPI_OFFSET, (uintptr_t) &train_rec,
+		      sizeof(train_rec), &act_read) != 0 ||
+	    act_read != sizeof(train_rec))
+		return false;
+
+	if (train_rec.magic != DDR_TRAIN_MAGIC ||
+	    train_rec.crc != ddr_train_crc(&train_rec)) {
+		VERBOSE("DDR: No saved training\n");
+		return false;
+	}
+
+	if (train_rec.cfg_crc != cfg_crc || train_rec.nregs != nregs) {
+		INFO("DDR: Configuration changed, saved training ignored\n");
+		return false;
+	}
+
+	memcpy(rec, &train_rec, sizeof(*rec));
+
+	return true;
+}
+
+void ddr_train_save(struct ddr_train_record *rec)
+{
+	if (!ddr_train_available())
+		return;
+
+	rec->magic = DDR_TRAIN_MAGIC;
+	rec->crc = ddr_train_crc(rec);
+
+	/* Only rewrites the sector if the training actually changed */
+	if (qspi_update(MCHP_DDR_TRAIN_QSPI_OFFSET, rec, sizeof(*rec), NULL) != 0)
+		NOTICE("DDR: Unable to save training\n");
+}
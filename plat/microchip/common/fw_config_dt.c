@@ -66,6 +66,26 @@ static int lan966x_fdt_get_prop(void *fdt,
 	return err;
 }
 
+/* DDR52 is opted into by the standard mmc DT properties */
+static bool lan966x_fdt_mmc_ddr(void *fdt)
+{
+	int node = fdt_node_offset_by_compatible(fdt, -1, "microchip,lan966x-sdhci");
+
+	return node >= 0 &&
+		(fdt_getprop(fdt, node, "mmc-ddr-1_8v", NULL) != NULL ||
+		 fdt_getprop(fdt, node, "mmc-ddr-3_3v", NULL) != NULL);
+}
+
+/* The board runs the MMC I/O at 1.8V, as required for HS200 and DDR52 */
+static bool lan966x_fdt_mmc_1v8(void *fdt)
+{
+	int node = fdt_node_offset_by_compatible(fdt, -1, "microchip,lan966x-sdhci");
+
+	return node >= 0 &&
+		(fdt_getprop(fdt, node, "mmc-hs200-1_8v", NULL) != NULL ||
+		 fdt_getprop(fdt, node, "mmc-ddr-1_8v", NULL) != NULL);
+}
+
 int lan966x_fw_config_get_prop(void *fdt, unsigned int offset, uint32_t *dst)
 {
 	uint32_t tmp;
@@ -94,10 +114,12 @@ int lan966x_fw_config_get_prop(void *fdt, unsigned int offset, uint32_t *dst)
 		if (err == 0) {
 			switch (tmp) {
 			case 8:
-				*dst = MMC_BUS_WIDTH_8;
+				*dst = lan966x_fdt_mmc_ddr(fdt) ?
+					MMC_BUS_WIDTH_DDR_8 : MMC_BUS_WIDTH_8;
 				break;
 			case 4:
-				*dst = MMC_BUS_WIDTH_4;
+				*dst = lan966x_fdt_mmc_ddr(fdt) ?
+					MMC_BUS_WIDTH_DDR_4 : MMC_BUS_WIDTH_4;
 				break;
 			case 1:
 				*dst = MMC_BUS_WIDTH_1;
@@ -108,6 +130,10 @@ int lan966x_fw_config_get_prop(void *fdt, unsigned int offset, uint32_t *dst)
 			}
 		}
 		break;
+	case LAN966X_FW_CONF_MMC_IO_1V8:
+		*dst = lan966x_fdt_mmc_1v8(fdt);
+		err = 0;
+		break;
 	case LAN966X_FW_CONF_QSPI_CLK:
 		err = lan966x_fdt_get_prop(fdt, "jedec,spi-nor", "spi-max-frequency", dst);
 		if (err == 0)
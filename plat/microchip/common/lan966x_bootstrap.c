@@ -6,11 +6,27 @@
 
 #include <assert.h>
 
+#include <drivers/delay_timer.h>
+
 #include <plat/microchip/common/lan966x_bootstrap.h>
 #include <plat/microchip/common/lan966x_crc32.h>
 
 static uint8_t bootstrap_req_flags;
 
+/* Windowed DATA transfer setup, frame_size == 0 => stop-and-wait */
+static struct {
+	uint32_t frame_size;
+	uint32_t frames;
+} bootstrap_window;
+
+/* Max idle time while receiving a window, 0 => wait forever */
+static uint32_t bootstrap_rx_timeout_us;
+static bool bootstrap_rx_timedout;
+
+static bootstrap_rx_hook_t bootstrap_rx_hook;
+static bootstrap_tx_write_t bootstrap_tx_write;
+static bootstrap_rx_read_t bootstrap_rx_read;
+
 static int hex2nibble(int ch)
 {
 	if ( ch >= '0' && ch <= '9' )
@@ -52,7 +68,25 @@ static void hex2str(char *buf, uint32_t val)
 
 static int MON_GET(void)
 {
-	return console_getc();
+	uint64_t timeout;
+	int c;
+
+	if (bootstrap_rx_timeout_us == 0)
+		return console_getc();
+
+	/* Once timed out, fail fast until the window is restarted */
+	if (bootstrap_rx_timedout)
+		return -1;
+
+	timeout = timeout_init_us(bootstrap_rx_timeout_us);
+	do {
+		c = console_try_getc();
+		if (c != ERROR_NO_PENDING_CHAR)
+			return c;
+	} while (!timeout_elapsed(timeout));
+
+	bootstrap_rx_timedout = true;
+	return -1;
 }
 
 static int MON_GET_Data(char *data, uint32_t length)
@@ -73,7 +107,10 @@ static int MON_GET_Data(char *data, uint32_t length)
 
 static void MON_PUT(char c)
 {
-	console_putc(c);
+	if (bootstrap_tx_write)
+		bootstrap_tx_write(&c, 1);
+	else
+		console_putc(c);
 }
 
 static uint32_t MON_PUT_Data(const void *buffer, uint32_t length, uint32_t crc)
@@ -81,21 +118,29 @@ static uint32_t MON_PUT_Data(const void *buffer, uint32_t length, uint32_t crc)
 	const unsigned char *data = buffer;
 	int i;
 
-	for (i = 0; i < length; i++)
-		MON_PUT(*data++);
+	if (bootstrap_tx_write)
+		bootstrap_tx_write(buffer, length);
+	else
+		for (i = 0; i < length; i++)
+			MON_PUT(*data++);
 
 	return Crc32c(crc, buffer, length);
 }
 
-static void bootstrap_RxPayload(uint8_t *data, bootstrap_req_t *req)
+/* Returns false if the payload could not be received in full */
+static bool bootstrap_RxPayload(uint8_t *data, bootstrap_req_t *req)
 {
 	int datasize = req->len;
 
 	if (req->flags & BSTRAP_REQ_FLAG_BINARY) {
 		uint8_t *ptr = data;
 
-		while (datasize--)
-			*ptr++ = (uint8_t) MON_GET();
+		if (bootstrap_rx_read) {
+			if (bootstrap_rx_read(data, datasize) != datasize)
+				return false;
+		} else
+			while (datasize--)
+				*ptr++ = (uint8_t) MON_GET();
 		req->crc = Crc32c(req->crc, data, req->len);
 	} else {
 		char in[2];
@@ -107,6 +152,8 @@ static void bootstrap_RxPayload(uint8_t *data, bootstrap_req_t *req)
 			req->crc = Crc32c(req->crc, in, sizeof(in));
 		}
 	}
+
+	return true;
 }
 
 static bool bootstrap_RxCrcCheck(bootstrap_req_t *req)
@@ -120,16 +167,33 @@ static bool bootstrap_RxCrcCheck(bootstrap_req_t *req)
 	return crc == req->crc;
 }
 
+/* Consume payload and CRC of a request we do not want */
+static void bootstrap_RxDiscard(bootstrap_req_t *req)
+{
+	uint32_t datasize = req->len;
+
+	if (!(req->flags & BSTRAP_REQ_FLAG_BINARY))
+		datasize *= 2;
+
+	while (datasize--)
+		(void) MON_GET();
+
+	(void) bootstrap_RxCrcCheck(req);
+}
+
 bool bootstrap_RxReq(bootstrap_req_t *req)
 {
 	bstrap_char_req_t rxdata;
-	int rx;
+	int rx, c;
 
 	bootstrap_req_flags = 0; /* Reset flags */
 
 	/* Syncronize SOF */
-	while(MON_GET() != BOOTSTRAP_SOF)
-		;
+	do {
+		c = MON_GET();
+		if (c < 0)
+			return false;
+	} while (c != BOOTSTRAP_SOF);
 
 	/* Read fixed parts */
 	rx = MON_GET_Data((char*)&rxdata, sizeof(rxdata));
@@ -162,11 +226,15 @@ bool bootstrap_RxReq(bootstrap_req_t *req)
 static uint32_t bootstrap_TxPayload(const uint8_t *data,
 				    uint32_t length, uint32_t crc)
 {
-	char out[2];
-
-	while (length--) {
-		hex2str_byte(out, *data++);
-		crc = MON_PUT_Data(out, sizeof(out), crc);
+	char out[64];
+	uint32_t i, chunk;
+
+	while (length) {
+		chunk = MIN(length, (uint32_t) sizeof(out) / 2);
+		for (i = 0; i < chunk; i++)
+			hex2str_byte(out + (2 * i), *data++);
+		crc = MON_PUT_Data(out, chunk * 2, crc);
+		length -= chunk;
 	}
 
 	return crc;
@@ -224,8 +292,13 @@ int bootstrap_RxData(uint8_t *data,
 			errtxt = "Data misordering";
 			goto send_err;
 		}
-		bootstrap_RxPayload(data, &req);
+		if (!bootstrap_RxPayload(data, &req)) {
+			errtxt = "Receive timeout";
+			goto send_err;
+		}
 		if (bootstrap_RxCrcCheck(&req)) {
+			if (bootstrap_rx_hook)
+				bootstrap_rx_hook(req.arg0 + req.len);
 			bootstrap_Tx(BOOTSTRAP_ACK, req.arg0, 0, NULL);
 			return req.len;
 		}
@@ -239,6 +312,127 @@ send_err:
 
 bool bootstrap_RxDataCrc(bootstrap_req_t *req, uint8_t *data)
 {
-	bootstrap_RxPayload(data, req);
-	return bootstrap_RxCrcCheck(req);
+	return bootstrap_RxPayload(data, req) && bootstrap_RxCrcCheck(req);
+}
+
+uint32_t bootstrap_SetWindow(uint32_t frame_size)
+{
+	if (frame_size == 0 || frame_size > BSTRAP_WINDOW_MAX_FRAME) {
+		/* Revert to stop-and-wait */
+		bootstrap_window.frame_size = 0;
+		bootstrap_window.frames = 0;
+	} else {
+		bootstrap_window.frame_size = frame_size;
+		bootstrap_window.frames = BSTRAP_WINDOW_FRAMES;
+	}
+
+	return bootstrap_window.frames;
+}
+
+bool bootstrap_WindowActive(void)
+{
+	return bootstrap_window.frames != 0;
+}
+
+void bootstrap_SetRxHook(bootstrap_rx_hook_t hook)
+{
+	bootstrap_rx_hook = hook;
+}
+
+void bootstrap_SetTxWrite(bootstrap_tx_write_t write)
+{
+	bootstrap_tx_write = write;
+}
+
+void bootstrap_SetRxRead(bootstrap_rx_read_t read)
+{
+	bootstrap_rx_read = read;
+}
+
+/*
+ * Receive 'length' bytes as a series of windows, each of up to
+ * 'frames' DATA frames addressed by offset. The host sends one frame
+ * per outstanding slot without waiting, and the target answers once
+ * per window: An ACK with the new cumulative offset when the window
+ * is complete, or a NACK with zero length and the mask of slots to
+ * retransmit in arg0. A NACK with an error text aborts the transfer.
+ * If the line goes idle before all frames are in, the window is closed
+ * with a NACK of the missing frames, so a lost frame cannot stall
+ * either end.
+ */
+int bootstrap_RxWindow(uint8_t *data, uint32_t length)
+{
+	const uint32_t frame_size = bootstrap_window.frame_size;
+	uint32_t base, win_len, offset, slot, missing, pending, retries;
+	bootstrap_req_t req;
+	int ret = 0;
+
+	assert(bootstrap_WindowActive());
+
+	bootstrap_rx_timeout_us = BSTRAP_WINDOW_TIMEOUT_US;
+
+	for (base = 0; base < length; base += win_len) {
+		win_len = MIN(length - base, frame_size * bootstrap_window.frames);
+		missing = GENMASK_32(div_round_up(win_len, frame_size) - 1, 0);
+
+		for (retries = 0; missing != 0; retries++) {
+			bootstrap_rx_timedout = false;
+
+			/* One frame per missing slot is on its way */
+			for (pending = missing; pending != 0; pending &= (pending - 1)) {
+				if (!bootstrap_RxReq(&req)) {
+					if (bootstrap_rx_timedout)
+						break;
+					continue;
+				}
+
+				if (!is_cmd(&req, BOOTSTRAP_DATA))
+					continue;
+
+				/* Keep in sync with the stream, drop it */
+				if (req.len > frame_size) {
+					bootstrap_RxDiscard(&req);
+					continue;
+				}
+
+				offset = req.arg0;
+				slot = (offset - base) / frame_size;
+				if (offset < base || offset >= (base + win_len) ||
+				    ((offset - base) % frame_size) != 0 ||
+				    req.len != MIN(frame_size, base + win_len - offset) ||
+				    !(missing & BIT(slot))) {
+					bootstrap_RxDiscard(&req);
+					continue;
+				}
+
+				if (bootstrap_RxPayload(data + offset, &req) &&
+				    bootstrap_RxCrcCheck(&req))
+					missing &= ~BIT(slot);
+			}
+
+			if (missing == 0)
+				break;
+
+			if (retries == BSTRAP_WINDOW_RETRIES) {
+				bootstrap_TxNack_rc("Too many retransmits", base);
+				ret = -1;
+				goto out;
+			}
+
+			/* Selective NACK, frames to retransmit */
+			bootstrap_Tx(BOOTSTRAP_NACK, missing, 0, NULL);
+		}
+
+		if (bootstrap_rx_hook)
+			bootstrap_rx_hook(base + win_len);
+
+		/* Cumulative ACK */
+		bootstrap_Tx(BOOTSTRAP_ACK, base + win_len, 0, NULL);
+	}
+
+out:
+	bootstrap_rx_timeout_us = 0;
+	bootstrap_rx_timedout = false;
+
+	return ret;
 }
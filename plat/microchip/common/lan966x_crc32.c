@@ -5,6 +5,11 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
+
+#if defined(__aarch64__)
+#include <arm_acle.h>
+#endif
 
 #include "lan966x_bootstrap.h"
 
@@ -102,12 +107,92 @@ static const uint32_t crc32Table[256] = {
 	0xBE2DA0A5L, 0x4C4623A6L, 0x5F16D052L, 0xAD7D5351L
 };
 
-uint32_t Crc32c(uint32_t crc, const void *data, size_t size)
+static uint32_t crc32c_bytes(uint32_t crc, const uint8_t *p, size_t size)
 {
-	const uint8_t *p = data;
-
-	crc = ~crc;
 	while (size--)
 		crc = crc32Table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
-	return ~crc;
+	return crc;
+}
+
+#if defined(__aarch64__)
+
+/* Cortex-A53: ARMv8 CRC32C instructions, 8 bytes at a time */
+static uint32_t crc32c_fast(uint32_t crc, const uint8_t *p, size_t size)
+{
+	size_t head = (-(uintptr_t) p) & 7U;
+
+	if (head > size)
+		head = size;
+	while (head--) {
+		crc = __crc32cb(crc, *p++);
+		size--;
+	}
+
+	for (; size >= 8U; size -= 8U, p += 8U)
+		crc = __crc32cd(crc, *(const uint64_t *) p);
+
+	while (size--)
+		crc = __crc32cb(crc, *p++);
+
+	return crc;
+}
+
+#else
+
+/* Slice-by-8: tables for the CRC of a byte followed by 1..7 zero bytes */
+static uint32_t crc32SliceTable[7][256];
+static bool crc32SliceInit;
+
+static void crc32c_slice_init(void)
+{
+	uint32_t crc;
+	int i, k;
+
+	for (i = 0; i < 256; i++) {
+		crc = crc32Table[i];
+		for (k = 0; k < 7; k++) {
+			crc = crc32Table[crc & 0xff] ^ (crc >> 8);
+			crc32SliceTable[k][i] = crc;
+		}
+	}
+
+	crc32SliceInit = true;
+}
+
+static uint32_t crc32c_fast(uint32_t crc, const uint8_t *p, size_t size)
+{
+	size_t head = (-(uintptr_t) p) & 3U;
+	uint32_t w0, w1;
+
+	if (size < 16U)
+		return crc32c_bytes(crc, p, size);
+
+	if (!crc32SliceInit)
+		crc32c_slice_init();
+
+	crc = crc32c_bytes(crc, p, head);
+	p += head;
+	size -= head;
+
+	for (; size >= 8U; size -= 8U, p += 8U) {
+		w0 = ((const uint32_t *) p)[0] ^ crc;
+		w1 = ((const uint32_t *) p)[1];
+		crc = crc32SliceTable[6][w0 & 0xff] ^
+			crc32SliceTable[5][(w0 >> 8) & 0xff] ^
+			crc32SliceTable[4][(w0 >> 16) & 0xff] ^
+			crc32SliceTable[3][w0 >> 24] ^
+			crc32SliceTable[2][w1 & 0xff] ^
+			crc32SliceTable[1][(w1 >> 8) & 0xff] ^
+			crc32SliceTable[0][(w1 >> 16) & 0xff] ^
+			crc32Table[w1 >> 24];
+	}
+
+	return crc32c_bytes(crc, p, size);
+}
+
+#endif
+
+uint32_t Crc32c(uint32_t crc, const void *data, size_t size)
+{
+	return ~crc32c_fast(~crc, data, size);
 }
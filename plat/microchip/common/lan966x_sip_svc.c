@@ -6,6 +6,8 @@
 
 #include <stdint.h>
 
+#include <arch_helpers.h>
+#include <boot_trace.h>
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <drivers/microchip/lan966x_trng.h>
@@ -258,6 +260,29 @@ static uintptr_t sip_ns_decrypt(uintptr_t enc, uintptr_t data, void *handle)
 	SMC_RET1(handle, SMC_ARCH_CALL_SUCCESS);
 }
 
+static uintptr_t sip_boot_trace(uintptr_t buf, size_t size, void *handle)
+{
+	size_t nrec;
+
+	/* Never more than the trace holds, also keeps size within 32 bits */
+	size = MIN(size, BOOT_TRACE_ENTRIES * sizeof(struct boot_trace_rec));
+
+	if (size < sizeof(struct boot_trace_rec) ||
+	    (buf % sizeof(uint64_t)) != 0 ||
+	    !is_ns_ddr(size, buf))
+		SMC_RET1(handle, SMC_ARCH_CALL_INVAL_PARAM);
+
+	/* Records oldest first, as many as fits */
+	nrec = boot_trace_export((void*) buf, size / sizeof(struct boot_trace_rec));
+	if (nrec == 0)
+		SMC_RET1(handle, SMC_ARCH_CALL_NOT_SUPPORTED);
+
+	flush_dcache_range(buf, nrec * sizeof(struct boot_trace_rec));
+
+	/* Return record count and counter frequency to convert timestamps */
+	SMC_RET3(handle, SMC_ARCH_CALL_SUCCESS, nrec, read_cntfrq_el0());
+}
+
 /*
  * This function is responsible for handling all SiP calls from the NS world
  */
@@ -347,6 +372,10 @@ static uintptr_t sip_smc_handler(uint32_t smc_fid,
 			 microchip_plat_bl2_version());
 		/* break is not required as SMC_RETx return */
 
+	case SIP_SVC_BOOT_TRACE:
+		/* Copy boot timestamp trace to provided buffer */
+		return sip_boot_trace(x1, x2, handle);
+
 	default:
 		return microchip_plat_sip_handler(smc_fid, x1, x2, x3, x4,
 						  cookie, handle, flags);
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <drivers/delay_timer.h>
+
+#include "lan966x_wait.h"
+
+/* Short waits (register handshakes) are not worth sleeping for */
+#define LAN966X_WAIT_SPIN_US	10U
+
+/* Installed once interrupts can wake the core, runtime images only */
+static lan966x_wait_sleep_t wait_sleep;
+
+void lan966x_wait_set_sleep(lan966x_wait_sleep_t sleep)
+{
+	wait_sleep = sleep;
+}
+
+void lan966x_wait_init(struct lan966x_wait *w, uint32_t timeout_us)
+{
+	w->timeout = timeout_init_us(timeout_us);
+	w->spin = timeout_init_us(LAN966X_WAIT_SPIN_US);
+}
+
+/*
+ * Call when the awaited condition is not (yet) met. Returns true if
+ * the wait timed out, otherwise the condition should be checked again
+ * - possibly after having slept in WFI.
+ */
+bool lan966x_wait_timeout(struct lan966x_wait *w)
+{
+	if (timeout_elapsed(w->timeout))
+		return true;
+
+	if (wait_sleep != NULL && timeout_elapsed(w->spin))
+		wait_sleep(w->timeout);
+
+	return false;
+}
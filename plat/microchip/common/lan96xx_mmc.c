@@ -7,10 +7,14 @@
 #include <assert.h>
 #include <string.h>
 
+#include <common/debug.h>
 #include <drivers/microchip/vcore_gpio.h>
 #include <drivers/microchip/emmc.h>
+#include <drivers/mmc.h>
 #include <fw_config.h>
 #include <lan96xx_mmc.h>
+#include <lib/utils_def.h>
+#include <tools_share/firmware_image_package.h>
 
 #include "platform_def.h"
 #include "lan966x_regs.h"
@@ -26,7 +30,7 @@ void lan966x_mmc_plat_config(boot_source_type boot_source)
 	struct mmc_device_info info;
 	lan966x_mmc_params_t params;
 	uint32_t clk_rate;
-	uint8_t bus_width;
+	uint8_t bus_width, io_1v8;
 
 	memset(&params, 0, sizeof(lan966x_mmc_params_t));
 	memset(&info, 0, sizeof(struct mmc_device_info));
@@ -54,6 +58,8 @@ void lan966x_mmc_plat_config(boot_source_type boot_source)
 	/* Update global lan966x_fw_config structure */
 	lan966x_fw_config_read_uint32(LAN966X_FW_CONF_MMC_CLK_RATE, &clk_rate, MMC_DEFAULT_SPEED);
 	lan966x_fw_config_read_uint8(LAN966X_FW_CONF_MMC_BUS_WIDTH, &bus_width, MMC_BUS_WIDTH_1);
+	lan966x_fw_config_read_uint8(LAN966X_FW_CONF_MMC_IO_1V8, &io_1v8, 0);
+	params.io_1v8 = (io_1v8 != 0);
 
 	/* Check if special configuration mode is set */
 	if (clk_rate == 0u) {
@@ -76,3 +82,63 @@ void lan966x_mmc_plat_config(boot_source_type boot_source)
 
 	lan966x_mmc_init(&params, &info);
 }
+
+/* Enough for the ToC of any sensible FIP */
+#define FIP_PREFETCH_TOC_SIZE	(8U * MMC_BLOCK_SIZE)
+
+/*
+ * Read the FIP at 'offset' into 'buf' with as few transfers as
+ * possible: first the ToC to learn the extent of the package, then the
+ * remainder as one sequential read. Returns the FIP length, or 0 if the
+ * FIP could not be prefetched.
+ */
+size_t lan96xx_mmc_fip_prefetch(size_t offset, size_t max_len,
+				uintptr_t buf, size_t buf_size)
+{
+	const fip_toc_header_t *header = (const fip_toc_header_t *) buf;
+	const fip_toc_entry_t *entry = (const fip_toc_entry_t *) (buf + sizeof(*header));
+	unsigned int i, max_entries;
+	size_t len, rest;
+	const uuid_t uuid_null = { 0 };
+	int lba = offset / MMC_BLOCK_SIZE;
+
+	max_len = MIN(max_len, buf_size);
+	if ((offset % MMC_BLOCK_SIZE) != 0 || max_len < FIP_PREFETCH_TOC_SIZE)
+		return 0;
+
+	if (mmc_read_blocks(lba, buf, FIP_PREFETCH_TOC_SIZE) != FIP_PREFETCH_TOC_SIZE)
+		return 0;
+
+	if (header->name != TOC_HEADER_NAME || header->serial_number == 0)
+		return 0;
+
+	/* The FIP ends with the last payload, or the ToC end marker */
+	max_entries = (FIP_PREFETCH_TOC_SIZE - sizeof(*header)) / sizeof(*entry);
+	for (i = 0; i < max_entries; i++, entry++) {
+		if (memcmp(&entry->uuid, &uuid_null, sizeof(uuid_t)) == 0)
+			break;
+		if (entry->offset_address > max_len ||
+		    entry->size > max_len - entry->offset_address)
+			return 0;
+	}
+	if (i == max_entries)
+		return 0;
+
+	len = sizeof(*header) + (i + 1) * sizeof(*entry);
+	for (entry = (const fip_toc_entry_t *) (buf + sizeof(*header)); i > 0; i--, entry++)
+		len = MAX(len, (size_t) (entry->offset_address + entry->size));
+
+	if (round_up(len, MMC_BLOCK_SIZE) > max_len)
+		return 0;
+
+	if (len > FIP_PREFETCH_TOC_SIZE) {
+		rest = round_up(len, MMC_BLOCK_SIZE) - FIP_PREFETCH_TOC_SIZE;
+		if (mmc_read_blocks(lba + (FIP_PREFETCH_TOC_SIZE / MMC_BLOCK_SIZE),
+				    buf + FIP_PREFETCH_TOC_SIZE, rest) != rest)
+			return 0;
+	}
+
+	INFO("MMC: Prefetched FIP, %zd bytes\n", len);
+
+	return len;
+}
@@ -185,18 +185,26 @@ static void handle_send_data(const bootstrap_req_t *req)
 	// Go ahead, receive data
 	bootstrap_TxAck();
 
-	/* Gobble up the data chunks */
-	nBytes = offset = 0;
-	while (offset < length &&
-	       (nBytes = bootstrap_RxData(ptr, offset,
-					  length - offset)) > 0) {
-		ptr += nBytes;
-		offset += nBytes;
-	}
+	if (bootstrap_WindowActive()) {
+		/* Data frames are sent in windows */
+		if (bootstrap_RxWindow(ptr, length) != 0) {
+			ERROR("RxWindow Error: l = %d\n", length);
+			return;
+		}
+	} else {
+		/* Gobble up the data chunks */
+		nBytes = offset = 0;
+		while (offset < length &&
+		       (nBytes = bootstrap_RxData(ptr, offset,
+						  length - offset)) > 0) {
+			ptr += nBytes;
+			offset += nBytes;
+		}
 
-	if (offset != length) {
-		ERROR("RxData Error: n = %d, l = %d, o = %d\n", nBytes, length, offset);
-		return;
+		if (offset != length) {
+			ERROR("RxData Error: n = %d, l = %d, o = %d\n", nBytes, length, offset);
+			return;
+		}
 	}
 
 	/* We have data */
@@ -208,6 +216,12 @@ static void handle_send_data(const bootstrap_req_t *req)
 	INFO("Received %d bytes\n", length);
 }
 
+static void handle_window(const bootstrap_req_t *req)
+{
+	/* arg0 is the DATA frame size, zero reverts to stop-and-wait */
+	bootstrap_Tx(BOOTSTRAP_ACK, bootstrap_SetWindow(req->arg0), 0, NULL);
+}
+
 void plat_bl1_bootstrap_monitor(void)
 {
 	bootstrap_req_t req;
@@ -239,6 +253,8 @@ void plat_bl1_bootstrap_monitor(void)
 			handle_sjtag_rd(&req);
 		else if (is_cmd(&req, BOOTSTRAP_SJTAG_WR))
 			handle_sjtag_wr(&req);
+		else if (is_cmd(&req, BOOTSTRAP_WINDOW))
+			handle_window(&req);
 		else
 			bootstrap_TxNack("Unknown command");
 	}
@@ -7,10 +7,14 @@
 #include <assert.h>
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
+#include <drivers/delay_timer.h>
+#include <drivers/io/io_driver.h>
+#include <drivers/io/io_fip.h>
 #include <drivers/io/io_storage.h>
 #include <drivers/microchip/lan966x_trng.h>
 #include <drivers/microchip/qspi.h>
 #include <drivers/microchip/sha.h>
+#include <drivers/microchip/xdmac.h>
 #include <drivers/mmc.h>
 #include <drivers/partition/partition.h>
 #include <endian.h>
@@ -20,6 +24,7 @@
 #include <plat/common/platform.h>
 #include <platform_def.h>
 #include <tf_gunzip.h>
+#include <tf_lz4.h>
 
 #include <lan96xx_common.h>
 #include <plat_bl2u_bootstrap.h>
@@ -37,12 +42,32 @@
 
 #define PAGE_ALIGN(x, a)	(((x) + (a) - 1) & ~((a) - 1))
 
+/* Streaming write parameters */
+#define STREAM_SHA_BLOCK	64U		/* SHA-256 block size */
+#define STREAM_EMMC_CHUNK	SIZE_K(64)	/* eMMC write granularity */
+#define STREAM_BUDGET_US	20000U		/* Max NOR work per DATA frame */
+#define STREAM_OP_TIMEOUT_US	2000000U	/* Max NOR block erase/program time */
+
 static const uintptr_t fip_base_addr = LAN966X_DDR_BASE;
 static uint32_t data_rcv_length;
 static struct ddr_config current_ddr_config;
 static const uintptr_t ddr_base_addr = LAN966X_DDR_BASE;
 static bool ddr_was_initialized, cur_cache;
 
+/* Streaming write state */
+static struct {
+	boot_source_type dev;
+	uint32_t offset;	/* Device offset */
+	uint32_t length;	/* Total length */
+	uint32_t received;	/* Contiguous bytes received */
+	uint32_t hashed;	/* Bytes fed to SHA */
+	uint32_t erased;	/* NOR bytes erased */
+	uint32_t written;	/* Bytes written to device */
+	uint64_t op_timeout;	/* Current NOR operation timeout */
+	void *sha;
+	int ret;
+} stream;
+
 #if defined(LAN969X_SRAM_SIZE)
 #define SRAM_BUFFER BL2_LIMIT
 #define SRAM_SIZE   (LAN969X_SRAM_SIZE - BL1_RW_SIZE - BL2U_SIZE)
@@ -167,6 +192,10 @@ static bool recv_data(uint8_t *ptr, uint32_t length)
 	// Go ahead, receive data
 	bootstrap_TxAck();
 
+	/* Data frames are sent in windows */
+	if (bootstrap_WindowActive())
+		return bootstrap_RxWindow(ptr, length) == 0;
+
 	/* Gobble up the data chunks */
 	num_bytes = 0;
 	offset = 0;
@@ -243,6 +272,29 @@ static bool valid_write_dev(boot_source_type dev)
 	return false;
 }
 
+/*
+ * Read back from the QSPI NOR and hash what was read. Where the DMA
+ * pipeline is available, the data is hashed as it lands rather than
+ * in a second pass over it.
+ */
+static int qspi_read_sha(uint32_t offset, uintptr_t buf, size_t length,
+			 lan966x_key32_t *hash)
+{
+	size_t act_read;
+	int ret;
+
+	xdmac_qspi_sha_request();
+	ret = qspi_read(offset, buf, length, &act_read);
+	if (ret != 0)
+		return ret;
+	if (act_read != length)
+		return -EPIPE;
+
+	/* Picks up the hash of a pipelined read */
+	return sha_calc(SHA_MR_ALGO_SHA256, (const void *) buf, length,
+			hash->b, sizeof(hash->b));
+}
+
 int lan966x_bl2u_emmc_block_write_read(uint32_t offset, void *buf, uint32_t length)
 {
 	uint32_t round_len, lba, written_bytes, read_bytes;
@@ -259,6 +311,7 @@ int lan966x_bl2u_emmc_block_write_read(uint32_t offset, void *buf, uint32_t leng
 	VERBOSE("Write image to offset: 0x%x, length: 0x%x, LBA 0x%x, round_len 0x%x\n",
 		offset, length, lba, round_len);
 
+	fip_dev_invalidate_toc_index();
 	written_bytes = mmc_write_blocks(lba, (uintptr_t) buf, round_len);
 
 	if (written_bytes != round_len) {
@@ -325,6 +378,19 @@ static void handle_write_readback(bootstrap_req_t *req)
 			bootstrap_TxNack("Decompression failure");
 			return;
 		}
+	} else if (is_lz4(sram_buffer, length)) {
+		uintptr_t in_buf, out_buf, out_start;
+
+		in_buf = (uintptr_t) sram_buffer;
+		out_start = out_buf = (uintptr_t) (sram_buffer + sram_available);
+		if (unlz4(&in_buf, length, &out_buf, sram_available) == 0) {
+			sram_write_buffer = (void*) out_start;
+			length = out_buf - out_start;
+			VERBOSE("Unpacked LZ4 data, length now %d bytes\n", length);
+		} else {
+			bootstrap_TxNack("Decompression failure");
+			return;
+		}
 	} else {
 		VERBOSE("Uncompressed data, length is %d bytes\n", length);
 		sram_write_buffer = sram_buffer;
@@ -342,18 +408,18 @@ static void handle_write_readback(bootstrap_req_t *req)
 	case BOOT_SOURCE_SDMMC:
 		ret = lan966x_bl2u_emmc_block_write_read(offset, sram_write_buffer, length);
 		break;
-	case BOOT_SOURCE_QSPI: {
-		size_t act_read;
-		ret = qspi_write(offset, sram_write_buffer, length);
+	case BOOT_SOURCE_QSPI:
+		fip_dev_invalidate_toc_index();
+		ret = qspi_update(offset, sram_write_buffer, length, NULL);
 		if (ret == 0) {
-			ret = qspi_read(offset, (uintptr_t) sram_write_buffer, length, &act_read);
-			if (ret != 0 || act_read != length) {
+			ret = qspi_read_sha(offset, (uintptr_t) sram_write_buffer, length,
+					    &data_read);
+			if (ret != 0) {
 				bootstrap_TxNack("Data readback failed");
 				return;
 			}
 		}
 		break;
-	}
 	default:
 		ret = -ENOTSUP;
 	}
@@ -363,8 +429,10 @@ static void handle_write_readback(bootstrap_req_t *req)
 		return;
 	}
 
-	/* Calculate SHA when read back write */
-	sha_calc(SHA_MR_ALGO_SHA256, sram_write_buffer, length, data_read.b, sizeof(data_read.b));
+	/* Calculate SHA when read back write, QSPI did while reading */
+	if (dev != BOOT_SOURCE_QSPI)
+		sha_calc(SHA_MR_ALGO_SHA256, sram_write_buffer, length,
+			 data_read.b, sizeof(data_read.b));
 
 	if (memcmp(data_write.b, data_read.b, sizeof(data_write.b)) != 0) {
 		bootstrap_TxNack("SHA mismatch, chunk write failed");
@@ -406,12 +474,34 @@ static void handle_unzip_data(const bootstrap_req_t *req)
 		} else {
 			INFO("Non-zipped data, length %d bytes\n", data_rcv_length);
 		}
+	} else if (is_lz4(ptr, data_rcv_length)) {
+		uintptr_t in_buf, out_buf, out_start;
+		size_t out_len;
+
+		INFO("Looks like LZ4 data\n");
+
+		/* Unpack after the input, then move in place */
+		in_buf = fip_base_addr;
+		out_start = out_buf = in_buf + PAGE_ALIGN(data_rcv_length, SIZE_M(1));
+		out_len = default_ddr_config.info.size - (out_buf - in_buf);
+		if (unlz4(&in_buf, data_rcv_length, &out_buf, out_len) == 0) {
+			out_len = out_buf - out_start;
+			memmove((void *)fip_base_addr, (const void *) out_start, out_len);
+			data_rcv_length = out_len;
+			INFO("Unpacked data, length now %d bytes\n", data_rcv_length);
+			resp = "Decompressed data";
+		} else {
+			INFO("Non-LZ4 data, length %d bytes\n", data_rcv_length);
+		}
 	}
 
 	/* Send response */
 	bootstrap_TxAckData_arg(resp, strlen(resp), data_rcv_length);
 }
 
+/* ADMA2 moves this in one command, while still giving progress output */
+#define EMMC_XFER_CHUNK	SIZE_M(8)
+
 /*
  * Chunked MMC write for better diagnostics and resilient to size-dependent timeouts
  */
@@ -419,8 +509,11 @@ static uint32_t chunked_mmc_write_blocks(uint32_t lba, uintptr_t buf_ptr, uint32
 {
 	uint32_t written;
 
+	/* Any FIP ToC indexed from this device is about to change */
+	fip_dev_invalidate_toc_index();
+
 	for (written = 0; written < length; ) {
-		size_t chunk = MIN((size_t) SIZE_M(1),
+		size_t chunk = MIN((size_t) EMMC_XFER_CHUNK,
 				   (size_t) (length - written));
 		if (mmc_write_blocks(lba, buf_ptr, chunk) != chunk) {
 			ERROR("Incomplete write at LBA 0x%x, wrote %d of %d bytes\n", lba, written, length);
@@ -445,7 +538,7 @@ static uint32_t chunked_mmc_read_blocks(uint32_t lba, uintptr_t buf_ptr, uint32_
 	uint32_t nread;
 
 	for (nread = 0; nread < length; ) {
-		size_t chunk = MIN((size_t) SIZE_M(1),
+		size_t chunk = MIN((size_t) EMMC_XFER_CHUNK,
 				   (size_t) (length - nread));
 		if (mmc_read_blocks(lba, buf_ptr, chunk) != chunk) {
 			ERROR("Incomplete read at LBA 0x%x, wrote %d of %d bytes\n", lba, nread, length);
@@ -550,26 +643,18 @@ int lan966x_bl2u_qspi_verify(uint32_t offset, uintptr_t buf_ptr, size_t length)
 {
 	lan966x_key32_t data_write, data_read;
 	uint8_t *data = (void*) buf_ptr;
-	size_t act_read;
 	int ret;
 
 	/* Calculate SHA of written data */
 	sha_calc(SHA_MR_ALGO_SHA256, data, length, data_write.b, sizeof(data_write.b));
 
-	ret = qspi_read(offset, buf_ptr, length, &act_read);
+	/* Read back, calculating its SHA */
+	ret = qspi_read_sha(offset, buf_ptr, length, &data_read);
 	if (ret) {
 		NOTICE("qspi_verify: Read returns %d\n", ret);
 		return ret;
 	}
 
-	if (act_read != length) {
-		NOTICE("qspi_verify: Read %zd bytes, expected %zd\n", act_read, length);
-		return -EPIPE;
-	}
-
-	/* Calculate SHA when read back write */
-	sha_calc(SHA_MR_ALGO_SHA256, data, length, data_read.b, sizeof(data_read.b));
-
 	if (memcmp(data_write.b, data_read.b, sizeof(data_write.b)) != 0) {
 		NOTICE("SHA mismatch, qspi verify failed");
 		return -ENXIO;
@@ -622,6 +707,7 @@ int fip_update(const char *name, uintptr_t buf_ptr, uint32_t len, bool verify)
 /* This routine will write the image data flash device */
 static void handle_write_image(const bootstrap_req_t * req)
 {
+	struct qspi_update_stats st;
 	int ret;
 	int dev = req->arg0 & 0x7F;
 	bool verify = !!(req->arg0 & 0x80);
@@ -648,9 +734,13 @@ static void handle_write_image(const bootstrap_req_t * req)
 		ret = lan966x_bl2u_emmc_write(0, fip_base_addr, data_rcv_length, verify);
 		break;
 	case BOOT_SOURCE_QSPI:
-		ret = qspi_write(0, (void*) fip_base_addr, data_rcv_length);
-		if (ret == 0)
+		fip_dev_invalidate_toc_index();
+		ret = qspi_update(0, (void*) fip_base_addr, data_rcv_length, &st);
+		if (ret == 0) {
+			NOTICE("QSPI: %d sectors rewritten, %d blank programmed, %d unchanged\n",
+			       st.rewritten, st.programmed, st.skipped);
 			ret = lan966x_bl2u_qspi_verify(0, fip_base_addr, data_rcv_length);
+		}
 		break;
 	default:
 		ret = -ENOTSUP;
@@ -673,6 +763,284 @@ static void handle_write_image(const bootstrap_req_t * req)
 	}
 }
 
+static void stream_hash(bool last)
+{
+	uint32_t len = stream.received - stream.hashed;
+
+	/* Only feed whole SHA blocks, except for the final part */
+	if (!last)
+		len = round_down(len, STREAM_SHA_BLOCK);
+
+	if (len) {
+		sha_update(stream.sha, (const void *) (fip_base_addr + stream.hashed), len);
+		stream.hashed += len;
+	}
+}
+
+static int stream_emmc_pump(bool last)
+{
+	uint32_t len = stream.received - stream.written;
+	uint32_t lba;
+
+	/* Write whole chunks, except for the final part */
+	if (last)
+		len = round_up(len, MMC_BLOCK_SIZE);
+	else
+		len = round_down(len, STREAM_EMMC_CHUNK);
+
+	if (len == 0)
+		return 0;
+
+	lba = (stream.offset + stream.written) / MMC_BLOCK_SIZE;
+	if (chunked_mmc_write_blocks(lba, fip_base_addr + stream.written, len) != len)
+		return -EIO;
+
+	stream.written += len;
+
+	return 0;
+}
+
+static int stream_qspi_wait(void)
+{
+	int ret;
+
+	while ((ret = qspi_busy()) != 0) {
+		if (ret < 0)
+			return ret;
+		if (timeout_elapsed(stream.op_timeout))
+			return -ETIMEDOUT;
+	}
+
+	return 0;
+}
+
+/*
+ * Start as many NOR erase/program operations as the data received
+ * allows, within the time budget. The last operation started is left
+ * running in the device while the next DATA frame is received.
+ */
+static int stream_qspi_pump(bool last)
+{
+	uint64_t budget = timeout_init_us(STREAM_BUDGET_US);
+	uint32_t len, avail;
+	int ret;
+
+	while (true) {
+		len = MIN(QSPI_PAGE_SIZE, stream.length - stream.written);
+		avail = MIN(stream.received, stream.erased);
+
+		/* Anything to do? */
+		if (!(stream.written < stream.length &&
+		      (stream.written + len) <= avail) &&
+		    stream.erased >= stream.length)
+			break;
+
+		ret = qspi_busy();
+		if (ret < 0)
+			return ret;
+
+		if (ret != 0) {
+			if (timeout_elapsed(stream.op_timeout))
+				return -ETIMEDOUT;
+			if (!last && timeout_elapsed(budget))
+				return 0;
+			continue;
+		}
+
+		if (stream.written < stream.length &&
+		    (stream.written + len) <= avail) {
+			/* Program data received within the erased area */
+			ret = qspi_program_start(stream.offset + stream.written,
+						 (const void *) (fip_base_addr + stream.written),
+						 len);
+			stream.written += len;
+		} else {
+			/* Erase ahead of the data, in blocks as large as fit */
+			ret = qspi_erase_block_start(stream.offset + stream.erased,
+						     round_up(stream.length, QSPI_SECTOR_SIZE) -
+						     stream.erased);
+			if (ret > 0) {
+				stream.erased += ret;
+				ret = 0;
+			}
+		}
+
+		if (ret != 0)
+			return ret;
+
+		stream.op_timeout = timeout_init_us(STREAM_OP_TIMEOUT_US);
+	}
+
+	/* Let the last operation complete */
+	return last ? stream_qspi_wait() : 0;
+}
+
+static int stream_pump(bool last)
+{
+	if (stream.dev == BOOT_SOURCE_QSPI)
+		return stream_qspi_pump(last);
+
+	return stream_emmc_pump(last);
+}
+
+/* Called with new data received, while the host awaits our ACK */
+static void stream_rx_hook(uint32_t length)
+{
+	stream.received = length;
+	stream_hash(false);
+
+	if (stream.ret == 0)
+		stream.ret = stream_pump(false);
+}
+
+static int stream_verify(const uint8_t *digest)
+{
+	lan966x_key32_t data_read;
+	int ret;
+
+	/* Read back written data, the data hash was calculated during receive */
+	if (stream.dev == BOOT_SOURCE_QSPI) {
+		ret = qspi_read_sha(stream.offset, fip_base_addr, stream.length, &data_read);
+	} else {
+		ret = lan966x_bl2u_emmc_read(stream.offset, fip_base_addr, stream.length);
+		if (ret == 0)
+			sha_calc(SHA_MR_ALGO_SHA256, (const void *) fip_base_addr,
+				 stream.length, data_read.b, sizeof(data_read.b));
+	}
+
+	if (ret != 0)
+		return -EPIPE;
+
+	if (memcmp(digest, data_read.b, sizeof(data_read.b)) != 0)
+		return -ENXIO;
+
+	return 0;
+}
+
+/*
+ * Receive data and write it to the flash device at the same time. The
+ * data is received into DDR as with BOOTSTRAP_SEND, but as each DATA
+ * frame arrives the flash work for the data received so far is
+ * advanced, and a running SHA-256 of the data is kept.
+ */
+static void handle_stream_write(bootstrap_req_t *req)
+{
+	lan966x_key32_t digest;
+	uint32_t length = req->arg0;
+	uint32_t args[2], offset;
+	bool verify, received;
+	int ret, dev;
+
+	if (req->len != sizeof(args) || !bootstrap_RxDataCrc(req, (uint8_t *)args)) {
+		bootstrap_TxNack("Stream write args error");
+		return;
+	}
+
+	/* Extra command args */
+	dev = args[0] & 0x7F;
+	verify = !!(args[0] & 0x80);
+	offset = args[1];
+
+	if (length == 0 || length > default_ddr_config.info.size) {
+		bootstrap_TxNack("Length Error");
+		return;
+	}
+
+	if (!ddr_was_initialized) {
+		bootstrap_TxNack("DDR must be initialized before data is sent");
+		return;
+	}
+
+	if (!valid_write_dev(dev)) {
+		bootstrap_TxNack("Unsupported target device");
+		return;
+	}
+
+	if ((offset % (dev == BOOT_SOURCE_QSPI ? QSPI_SECTOR_SIZE : MMC_BLOCK_SIZE)) != 0) {
+		bootstrap_TxNack("Unaligned device offset");
+		return;
+	}
+
+	/* Refuse up front rather than fail with the device partly written */
+	if (dev == BOOT_SOURCE_QSPI &&
+	    (offset >= LAN966X_QSPI0_RANGE || length > LAN966X_QSPI0_RANGE - offset)) {
+		bootstrap_TxNack("Write exceeds device size");
+		return;
+	}
+
+	/* Init IO layer */
+	lan966x_bl2u_io_init_dev(dev);
+
+	memset(&stream, 0, sizeof(stream));
+	stream.dev = dev;
+	stream.offset = offset;
+	stream.length = length;
+
+	fip_dev_invalidate_toc_index();
+
+	if (dev == BOOT_SOURCE_QSPI && qspi_write_begin() != 0) {
+		bootstrap_TxNack("NOR write enable failed");
+		return;
+	}
+
+	stream.sha = sha_calc_init(SHA_MR_ALGO_SHA256, length, sizeof(digest.b));
+	assert(stream.sha != NULL);
+
+	/* Go ahead, receive data - flash is written as it arrives */
+	data_rcv_length = 0;
+	bootstrap_SetRxHook(stream_rx_hook);
+	received = recv_data((uint8_t *)fip_base_addr, length);
+	bootstrap_SetRxHook(NULL);
+
+	if (!received) {
+		/* Rx error already reported */
+		sha_abort(stream.sha);
+		if (dev == BOOT_SOURCE_QSPI) {
+			(void) stream_qspi_wait();
+			qspi_write_end();
+		}
+		return;
+	}
+
+	/* Complete hash and flash work */
+	stream.received = length;
+	stream_hash(true);
+	(void) sha_calc_finish(stream.sha, digest.b);
+	ret = stream.ret;
+	if (ret == 0)
+		ret = stream_pump(true);
+	if (dev == BOOT_SOURCE_QSPI)
+		qspi_write_end();
+
+	if (ret == 0) {
+		/* Data is in DDR as for BOOTSTRAP_SEND */
+		data_rcv_length = length;
+		if (verify) {
+			ret = stream_verify(digest.b);
+			if (ret != 0)
+				data_rcv_length = 0;
+		}
+	}
+
+	VERBOSE("Stream write of %d bytes: %d\n", length, ret);
+
+	switch (ret) {
+	case 0:
+		/* Return hash, length */
+		bootstrap_TxAckData_arg(digest.b, sizeof(digest.b), length);
+		break;
+	case -EPIPE:
+		bootstrap_TxNack("Image readback failed");
+		break;
+	case -ENXIO:
+		bootstrap_TxNack("Image verify failed");
+		break;
+	default:
+		bootstrap_TxNack_rc("Image write failed", ret);
+		break;
+	}
+}
+
 #pragma weak lan966x_bl2u_fip_read
 int lan966x_bl2u_fip_read(boot_source_type dev,
 			  uintptr_t buf,
@@ -722,6 +1090,7 @@ int lan966x_bl2u_fip_update(boot_source_type boot_source,
 			    uint32_t len,
 			    bool verify)
 {
+	struct qspi_update_stats st;
 	int ret;
 
 	/* Write Flash */
@@ -745,9 +1114,13 @@ int lan966x_bl2u_fip_update(boot_source_type boot_source,
 
 	case BOOT_SOURCE_QSPI:
 		INFO("Write FIP %d bytes to QSPI NOR\n", len);
-		ret = qspi_write(0, (void*) buf, len);
-		if (ret == 0)
+		fip_dev_invalidate_toc_index();
+		ret = qspi_update(0, (void*) buf, len, &st);
+		if (ret == 0) {
+			NOTICE("QSPI: %d sectors rewritten, %d blank programmed, %d unchanged\n",
+			       st.rewritten, st.programmed, st.skipped);
 			ret = lan966x_bl2u_qspi_verify(0, buf, len);
+		}
 		break;
 
 	default:
@@ -997,7 +1370,9 @@ static void handle_ddr_cfg_get(bootstrap_req_t *req)
 
 static void handle_ddr_test(bootstrap_req_t *req)
 {
-	bool cache = !!(req->arg0 & 1);
+	bool cache = !!(req->arg0 & BSTRAP_DDR_TEST_CACHE);
+	uint32_t tests = BSTRAP_DDR_TEST_DMA(req->arg0);
+	struct ddr_test_result res;
 	uintptr_t err_off;
 
 	if (!ddr_was_initialized) {
@@ -1022,14 +1397,59 @@ static void handle_ddr_test(bootstrap_req_t *req)
 		return;
 	}
 
-	err_off = ddr_test_rnd(ddr_base_addr, current_ddr_config.info.size, cache, 0xdeadbeef);
+	/* DMA/SHA tests if any selected, else the CPU sweep */
+	if (tests != 0U)
+		err_off = ddr_test_dma(ddr_base_addr, current_ddr_config.info.size,
+				       tests, 0xdeadbeef, &res);
+	else
+		err_off = ddr_test_rnd(ddr_base_addr, current_ddr_config.info.size,
+				       cache, 0xdeadbeef);
 	if (err_off != 0) {
 		bootstrap_TxNack_rc("DDR sweep test", err_off);
 		return;
 	}
 
-	/* All good */
-	bootstrap_TxAckStr("Test succeeded");
+	/* All good, DMA tests return their timing */
+	if (tests != 0U)
+		bootstrap_TxAckData(&res, sizeof(res));
+	else
+		bootstrap_TxAckStr("Test succeeded");
+}
+
+#define DDR_BENCH_SIZE	SIZE_M(16)	/* Default bytes per pass */
+
+static void handle_ddr_bench(bootstrap_req_t *req)
+{
+	size_t size = req->arg0 != 0U ? SIZE_M(req->arg0) : DDR_BENCH_SIZE;
+	bool cache = cur_cache;
+	struct ddr_bench res = { };
+
+	if (!ddr_was_initialized) {
+		bootstrap_TxNack("DDR not initialized");
+		return;
+	}
+
+	/* Copies need twice the size */
+	if (req->arg0 > (current_ddr_config.info.size / SIZE_M(2))) {
+		bootstrap_TxNack("Benchmark size too large");
+		return;
+	}
+
+	if (!set_cache(false))
+		return;		/* Error */
+
+	ddr_bench_cpu(ddr_base_addr, size, &res, &res.nocache);
+	ddr_bench_dma(ddr_base_addr, size, &res);
+
+	if (!set_cache(true))
+		return;		/* Error */
+
+	ddr_bench_cpu(ddr_base_addr, size, &res, &res.cache);
+
+	if (!set_cache(cache))
+		return;		/* Error */
+
+	bootstrap_TxAckData(&res, sizeof(res));
 }
 
 static void handle_data_hash(bootstrap_req_t *req)
@@ -1086,6 +1506,12 @@ static void handle_sram_info(bootstrap_req_t *req)
 	bootstrap_Tx(BOOTSTRAP_ACK, sram_available, 0, NULL);
 }
 
+static void handle_window(bootstrap_req_t *req)
+{
+	/* arg0 is the DATA frame size, zero reverts to stop-and-wait */
+	bootstrap_Tx(BOOTSTRAP_ACK, bootstrap_SetWindow(req->arg0), 0, NULL);
+}
+
 void lan966x_bl2u_bootstrap_monitor(void)
 {
 	bool exit_monitor = false;
@@ -1133,6 +1559,8 @@ void lan966x_bl2u_bootstrap_monitor(void)
 			handle_ddr_cfg_get(&req);
 		else if (is_cmd(&req, BOOTSTRAP_DDR_TEST))	// T - Perform DDR test
 			handle_ddr_test(&req);
+		else if (is_cmd(&req, BOOTSTRAP_DDR_BENCH))	// M - DDR benchmark
+			handle_ddr_bench(&req);
 		else if (is_cmd(&req, BOOTSTRAP_DATA_HASH))	// H - Get data hash
 			handle_data_hash(&req);
 		else if (is_cmd(&req, BOOTSTRAP_READ_REG))	// x - Read registers
@@ -1143,6 +1571,10 @@ void lan966x_bl2u_bootstrap_monitor(void)
 			handle_send_sram(&req);
 		else if (is_cmd(&req, BOOTSTRAP_WRITE_READBACK)) // j - Write SRAM data to device, with readback
 			handle_write_readback(&req);
+		else if (is_cmd(&req, BOOTSTRAP_WINDOW))	// w - Set up windowed DATA transfer
+			handle_window(&req);
+		else if (is_cmd(&req, BOOTSTRAP_STREAM_WRITE))	// F - Receive and write data to flash device
+			handle_stream_write(&req);
 		else
 			bootstrap_TxNack("Unknown command");
 	}
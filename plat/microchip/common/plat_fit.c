@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <drivers/microchip/sha.h>
+#include <drivers/microchip/xdmac.h>
+#include <lib/utils_def.h>
+#include <libfit.h>
+
+/* FIT hash algorithms the SHA engine does */
+static const struct {
+	const char *name;
+	lan966x_sha_type_t type;
+	size_t len;
+} fit_hash_algos[] = {
+	{ "sha1",   SHA_MR_ALGO_SHA1,   20 },
+	{ "sha224", SHA_MR_ALGO_SHA224, 28 },
+	{ "sha256", SHA_MR_ALGO_SHA256, 32 },
+	{ "sha384", SHA_MR_ALGO_SHA384, 48 },
+	{ "sha512", SHA_MR_ALGO_SHA512, 64 },
+};
+
+int fit_plat_hash(const char *algo, uintptr_t dst, const void *src, size_t len,
+		  void *hash, size_t hash_len)
+{
+	struct xdmac_pipeline pl = { 0 };
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(fit_hash_algos); i++)
+		if (strcmp(algo, fit_hash_algos[i].name) == 0)
+			break;
+
+	if (i == ARRAY_SIZE(fit_hash_algos))
+		return -ENOTSUP;
+
+	if (hash_len != fit_hash_algos[i].len)
+		return -EINVAL;
+
+	if (dst == 0)
+		return sha_calc(fit_hash_algos[i].type, src, len, hash, hash_len);
+
+	/* Copy and hash the copy as it lands, one pass over the data */
+	pl.dst = (void *) dst;
+	pl.src = src;
+	pl.len = len;
+	pl.nstages = 2;
+	pl.stages[0].op = XDMAC_STAGE_COPY;
+	pl.stages[1].op = XDMAC_STAGE_SHA;
+	pl.stages[1].sha.type = fit_hash_algos[i].type;
+	pl.stages[1].sha.hash = hash;
+	pl.stages[1].sha.hash_len = hash_len;
+
+	return xdmac_pipeline_run(&pl);
+}
@@ -31,16 +31,22 @@ static const lan966x_key32_t lan966x_bssk_derive = {
 #define LAN966X_ROTPK_HEADER	sizeof(lan966x_rotpk_header)
 
 static uint8_t rotpk_hash_der[LAN966X_ROTPK_HEADER + LAN966X_ROTPK_HASH_LEN];
+static bool rotpk_valid;
+static unsigned int rotpk_gen;	/* otp_write_generation() when read */
 
 int plat_get_rotpk_info(void *cookie, void **key_ptr, unsigned int *key_len,
 			unsigned int *flags)
 {
 	uint8_t *rotpk = &rotpk_hash_der[LAN966X_ROTPK_HEADER];
-	int ret;
-
-	memcpy(rotpk_hash_der, lan966x_rotpk_header, sizeof(lan966x_rotpk_header));
-
-	ret = otp_read_otp_tbbr_rotpk(rotpk, LAN966X_ROTPK_HASH_LEN);
+	int ret = 0;
+
+	/* Asked for every certificate, only read OTP once */
+	if (!rotpk_valid || rotpk_gen != otp_write_generation()) {
+		memcpy(rotpk_hash_der, lan966x_rotpk_header, sizeof(lan966x_rotpk_header));
+		ret = otp_read_otp_tbbr_rotpk(rotpk, LAN966X_ROTPK_HASH_LEN);
+		rotpk_valid = (ret == 0);
+		rotpk_gen = otp_write_generation();
+	}
 
 	if (ret < 0 || otp_all_zero(rotpk, LAN966X_ROTPK_HASH_LEN)) {
 		*flags = ROTPK_NOT_DEPLOYED;
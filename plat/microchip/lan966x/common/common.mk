@@ -47,6 +47,7 @@ $(eval $(call add_define,LAN966x_MAX_CPUS_PER_CLUSTER))
 $(eval $(call add_define,LAN966x_MAX_PE_PER_CPU))
 
 include lib/xlat_tables_v2/xlat_tables.mk
+include lib/lz4/lz4.mk
 include lib/zlib/zlib.mk
 
 $(info Including platform TBBR)
@@ -59,6 +60,25 @@ include drivers/microchip/crypto/lan966x_crypto.mk
 # MCHP SOC family
 $(eval $(call add_define,MCHP_SOC_LAN966X))
 
+# Nap in WFI between polls awaiting DMA/crypto completion in runtime services
+MCHP_WFI_WAIT		?= 0
+$(eval $(call add_define,MCHP_WFI_WAIT))
+
+# Read the whole FIP into DDR in one go when booting from eMMC/SD
+MCHP_FIP_PREFETCH	?= 0
+$(eval $(call add_define,MCHP_FIP_PREFETCH))
+
+# Record boot stage timestamps, readable through SiP
+MCHP_BOOT_TRACE		?= 1
+$(eval $(call add_define,MCHP_BOOT_TRACE))
+
+# QSPI NOR offset of a reserved sector to save DDR training results
+# in, skipping training on later boots. Disabled when empty.
+MCHP_DDR_TRAIN_QSPI_OFFSET	?=
+ifneq (${MCHP_DDR_TRAIN_QSPI_OFFSET},)
+$(eval $(call add_define,MCHP_DDR_TRAIN_QSPI_OFFSET))
+endif
+
 # We have OTP emulation enabled
 $(eval $(call add_define,MCHP_OTP_EMULATION))
 
@@ -76,6 +96,8 @@ PLAT_INCLUDES	:=	-Iinclude/plat/microchip/common				\
 LAN966X_CONSOLE_SOURCES	:=	\
 				drivers/microchip/gpio/vcore_gpio.c			\
 				drivers/microchip/qspi/qspi.c				\
+				drivers/microchip/qspi/qspi_update.c			\
+				drivers/mtd/nor/spi_nor_erase.c				\
 				drivers/microchip/flexcom_uart/aarch32/flexcom_console.S \
 				drivers/gpio/gpio.c					\
 
@@ -96,6 +118,7 @@ PLAT_BL_COMMON_SOURCES	+=	\
 				${LAN966X_CONSOLE_SOURCES}				\
 				${LAN966X_STORAGE_SOURCES}				\
 				${XLAT_TABLES_LIB_SRCS}					\
+				$(LZ4_SOURCES)						\
 				$(ZLIB_SOURCES)						\
 				common/desc_image_load.c				\
 				drivers/delay_timer/delay_timer.c			\
@@ -103,11 +126,13 @@ PLAT_BL_COMMON_SOURCES	+=	\
 				drivers/microchip/clock/lan966x_clock.c			\
 				drivers/microchip/crypto/lan966x_sha.c			\
 				drivers/microchip/dma/xdmac.c				\
+				drivers/microchip/dma/xdmac_pipeline.c			\
 				drivers/microchip/otp/otp.c				\
 				drivers/microchip/tz_matrix/tz_matrix.c			\
 				lib/cpus/aarch32/cortex_a7.S				\
 				plat/microchip/common/fw_config.c			\
 				plat/microchip/common/lan966x_crc32.c			\
+				plat/microchip/common/lan966x_wait.c			\
 				plat/microchip/common/lan96xx_common.c			\
 				plat/microchip/common/plat_crypto.c			\
 				plat/microchip/common/plat_tbbr.c			\
@@ -117,6 +142,7 @@ PLAT_BL_COMMON_SOURCES	+=	\
 				drivers/microchip/trng/lan966x_trng.c
 
 BL1_SOURCES		+=	\
+				drivers/microchip/usb/usb.c				\
 				plat/microchip/common/lan966x_bootstrap.c		\
 				plat/microchip/common/lan966x_sjtag.c			\
 				plat/microchip/common/plat_bl1_bootstrap.c		\
@@ -126,6 +152,7 @@ BL1_SOURCES		+=	\
 				plat/microchip/lan966x/common/lan966x_tbbr.c
 
 BL2_SOURCES		+=	\
+				drivers/microchip/otp/otp_tags.c			\
 				plat/microchip/common/ddr_test.c			\
 				plat/microchip/common/lan966x_sjtag.c			\
 				plat/microchip/lan966x/common/lan966x_io_storage.c	\
@@ -137,7 +164,8 @@ BL2_SOURCES		+=	\
 				plat/microchip/lan966x/common/lan966x_tbbr.c		\
 				plat/microchip/lan966x/common/lan966x_tz.c
 
-BL2U_SOURCES		+=	plat/microchip/common/ddr_test.c			\
+BL2U_SOURCES		+=	drivers/microchip/usb/usb.c				\
+				plat/microchip/common/ddr_test.c			\
 				plat/microchip/common/lan966x_bootstrap.c		\
 				plat/microchip/common/lan966x_fw_bind.c			\
 				plat/microchip/common/plat_bl2u_bootstrap.c		\
@@ -178,6 +206,14 @@ ifneq (${ENABLE_STACK_PROTECTOR},0)
 PLAT_BL_COMMON_SOURCES  +=      plat/microchip/common/lan966x_stack_protector.c
 endif
 
+ifneq (${MCHP_BOOT_TRACE},0)
+PLAT_BL_COMMON_SOURCES  +=      plat/microchip/common/boot_trace.c
+endif
+
+ifneq (${MCHP_DDR_TRAIN_QSPI_OFFSET},)
+BL2_SOURCES		+=	plat/microchip/common/ddr_train.c
+endif
+
 # Generate binary FW configuration data for inclusion in the FIPs FW_CONFIG
 LAN966X_FW_PARAM	:=	${BUILD_PLAT}/fw_param.bin
 
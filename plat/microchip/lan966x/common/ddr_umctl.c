@@ -10,7 +10,10 @@
 #include <ddr_init.h>
 #include <ddr_reg.h>
 #include <ddr_test.h>
+#include <ddr_train.h>
 #include <ddr_xlist.h>
+#include <lan966x_crc32.h>
+#include <lib/cassert.h>
 #include <platform_def.h>
 
 #define PGSR_ERR_MASK		GENMASK_32(27, 20)
@@ -72,6 +75,20 @@ static const struct reg_desc ddr_phy_timing_reg[] = {
 	XLIST_DDR_PHY_TIMING
 };
 
+/* PHY registers holding the data training results */
+static const uintptr_t ddr_train_reg[] = {
+#define TRAIN_REGS(n)							\
+	DDR_PHY_DX ## n ## BDLR0, DDR_PHY_DX ## n ## BDLR1,		\
+	DDR_PHY_DX ## n ## BDLR2, DDR_PHY_DX ## n ## BDLR3,		\
+	DDR_PHY_DX ## n ## BDLR4, DDR_PHY_DX ## n ## LCDLR0,		\
+	DDR_PHY_DX ## n ## LCDLR1, DDR_PHY_DX ## n ## LCDLR2,		\
+	DDR_PHY_DX ## n ## MDLR, DDR_PHY_DX ## n ## GTR
+	TRAIN_REGS(0),
+	TRAIN_REGS(1),
+#undef TRAIN_REGS
+};
+CASSERT(ARRAY_SIZE(ddr_train_reg) <= DDR_TRAIN_MAX_REGS, assert_ddr_train_reg_size);
+
 static bool wait_reg_set(uintptr_t reg, uint32_t mask, int usec)
 {
 	uint64_t t = timeout_init_us(usec);
@@ -352,6 +369,32 @@ static void ddr_restore_refresh(uint32_t rfshctl3, uint32_t pwrctl)
 	sw_done_ack();
 }
 
+/* Common end of training: normal refresh, updates and AXI ports back on */
+static void data_training_finish(const struct ddr_config *cfg)
+{
+	ddr_restore_refresh(cfg->main.rfshctl3, cfg->main.pwrctl);
+
+	/* Reenabling uMCTL2 initiated update request after executing
+	 * DDR initization. Reference: DDR4 MultiPHY PUB databook
+	 * (3.11a) PIR.INIT description (pg no. 114)
+	 */
+	sw_done_start();
+	mmio_clrbits_32(DDR_UMCTL2_DFIUPD0, DFIUPD0_DIS_AUTO_CTRLUPD);
+	sw_done_ack();
+
+	/* Reenabling PHY update Request after executing DDR
+	 * initization. Reference: DDR4 MultiPHY PUB databook (3.11a)
+	 * PIR.INIT description (pg no. 114)
+	 */
+	mmio_setbits_32(DDR_PHY_DSGCR, DSGCR_PUREN);
+
+	/* Enable AXI port(s) */
+	axi_enable_ports(true);
+
+	/* Settle */
+	ddr_usleep(1);
+}
+
 static int do_data_training(const struct ddr_config *cfg)
 {
 	int rc;
@@ -386,45 +429,53 @@ static int do_data_training(const struct ddr_config *cfg)
 		return -EIO;
 	}
 
-	ddr_restore_refresh(cfg->main.rfshctl3, cfg->main.pwrctl);
+	data_training_finish(cfg);
 
-	/* Reenabling uMCTL2 initiated update request after executing
-	 * DDR initization. Reference: DDR4 MultiPHY PUB databook
-	 * (3.11a) PIR.INIT description (pg no. 114)
-	 */
-	sw_done_start();
-	mmio_clrbits_32(DDR_UMCTL2_DFIUPD0, DFIUPD0_DIS_AUTO_CTRLUPD);
-	sw_done_ack();
+	VERBOSE("do_data_training:exit\n");
 
-	/* Reenabling PHY update Request after executing DDR
-	 * initization. Reference: DDR4 MultiPHY PUB databook (3.11a)
-	 * PIR.INIT description (pg no. 114)
-	 */
-	mmio_setbits_32(DDR_PHY_DSGCR, DSGCR_PUREN);
+	return 0;
+}
 
-	/* Enable AXI port(s) */
-	axi_enable_ports(true);
+/*
+ * Instead of training, load the delays found by an earlier training
+ * of the same configuration.
+ */
+static void restore_data_training(const struct ddr_config *cfg,
+				  const struct ddr_train_record *rec)
+{
+	int i;
 
-	/* Settle */
-	ddr_usleep(1);
+	VERBOSE("restore_data_training:enter\n");
 
-	VERBOSE("do_data_training:exit\n");
+	/* Disable Auto refresh and power down while changing delays */
+	ddr_disable_refresh();
 
-	return 0;
+	for (i = 0; i < ARRAY_SIZE(ddr_train_reg); i++)
+		mmio_write_32(ddr_train_reg[i], rec->regs[i]);
+
+	data_training_finish(cfg);
+
+	VERBOSE("restore_data_training:exit\n");
 }
 
-int ddr_init(const struct ddr_config *cfg)
+static void save_data_training(uint32_t cfg_crc)
 {
-	int ret;
+	struct ddr_train_record rec = {
+		.cfg_crc = cfg_crc,
+		.nregs = ARRAY_SIZE(ddr_train_reg),
+	};
+	int i;
 
-	strlcpy(ddr_failure_details, "No error", sizeof(ddr_failure_details));
+	for (i = 0; i < ARRAY_SIZE(ddr_train_reg); i++)
+		rec.regs[i] = mmio_read_32(ddr_train_reg[i]);
 
-	VERBOSE("ddr_init:start\n");
+	ddr_train_save(&rec);
+}
 
-	NOTICE("DDR: %s, %d MHz, %dMiB, ECC %s\n", cfg->info.name,
-	       cfg->info.speed,
-	       cfg->info.size / 1024 / 1024,
-	       cfg->main.ecccfg0 & ECCCFG0_ECC_MODE ? "enabled" : "disabled");
+static int ddr_start(const struct ddr_config *cfg,
+		     const struct ddr_train_record *rec)
+{
+	int ret;
 
 	/* Reset, start clocks at desired speed */
 	ret = ddr_reset(cfg, true);
@@ -480,7 +531,9 @@ int ddr_init(const struct ddr_config *cfg)
 	/* wait 2ms for STAT.operating_mode to become "normal" */
 	wait_operating_mode(1, TIME_MS_TO_US(2U));
 
-	if (do_data_training(cfg)) {
+	if (rec != NULL) {
+		restore_data_training(cfg, rec);
+	} else if (do_data_training(cfg)) {
 		ERROR("Data training failed\n");
 		return -EIO;
 	}
@@ -492,6 +545,54 @@ int ddr_init(const struct ddr_config *cfg)
 		}
 	}
 
+	return 0;
+}
+
+/* Quick check of restored training, before trusting it */
+static bool ddr_train_valid(void)
+{
+	return ddr_test_data_bus(PLAT_LAN966X_NS_IMAGE_BASE, true) == 0 &&
+		ddr_test_addr_bus(PLAT_LAN966X_NS_IMAGE_BASE,
+				  PLAT_LAN966X_NS_IMAGE_SIZE, true) == 0;
+}
+
+int ddr_init(const struct ddr_config *cfg)
+{
+	struct ddr_train_record rec;
+	uint32_t cfg_crc = 0;
+	int ret;
+
+	strlcpy(ddr_failure_details, "No error", sizeof(ddr_failure_details));
+
+	VERBOSE("ddr_init:start\n");
+
+	NOTICE("DDR: %s, %d MHz, %dMiB, ECC %s\n", cfg->info.name,
+	       cfg->info.speed,
+	       cfg->info.size / 1024 / 1024,
+	       cfg->main.ecccfg0 & ECCCFG0_ECC_MODE ? "enabled" : "disabled");
+
+	if (DDR_TRAIN_CACHE) {
+		cfg_crc = Crc32c(0, cfg, sizeof(*cfg));
+
+		/* Skip training if an earlier result still works */
+		if (ddr_train_load(cfg_crc, ARRAY_SIZE(ddr_train_reg), &rec)) {
+			if (ddr_start(cfg, &rec) == 0 && ddr_train_valid()) {
+				INFO("DDR: Using saved training\n");
+				VERBOSE("ddr_init:done\n");
+				return 0;
+			}
+			NOTICE("DDR: Saved training failed, retraining\n");
+			strlcpy(ddr_failure_details, "No error", sizeof(ddr_failure_details));
+		}
+	}
+
+	ret = ddr_start(cfg, NULL);
+	if (ret)
+		return ret;
+
+	if (DDR_TRAIN_CACHE)
+		save_data_training(cfg_crc);
+
 	VERBOSE("ddr_init:done\n");
 
 	return 0;
@@ -16,6 +16,7 @@ typedef struct {
 	void *fw_config;
 	void *mbedtls_heap_addr;
 	size_t mbedtls_heap_size;
+	uintptr_t boot_trace;
 } shared_memory_desc_t;
 
 extern shared_memory_desc_t shared_memory_desc;
@@ -26,6 +27,8 @@ typedef struct {
 	uint32_t ddr_size;
 	size_t   boot_offset;
 	uint32_t bl2_version;
+	uintptr_t boot_trace;
+	uintptr_t otp_tags;
 } bl32_params_t;
 
 /* GPR(3) = tag below, GPR(4) = size, GPR(5) = ptr */
@@ -38,6 +38,8 @@
 #define MAX_IO_HANDLES			4
 /* eMMC RPMB and eMMC User Data */
 #define MAX_IO_BLOCK_DEVICES		U(2)
+/* FIP ToC entries indexed by io_fip */
+#define FIP_TOC_INDEX_ENTRIES		U(24)
 
 /*
  * BL1 specific defines.
@@ -102,6 +104,17 @@
 #define PLAT_LAN966X_NS_IMAGE_SIZE	(LAN966X_DDR_ATF_SIZE - BL32_SIZE)
 #define PLAT_LAN966X_NS_IMAGE_LIMIT	(PLAT_LAN966X_NS_IMAGE_BASE + PLAT_LAN966X_NS_IMAGE_SIZE)
 
+/* BL2 scratch for a prefetched FIP, top of the NS area */
+#define PLAT_LAN966X_FIP_PREFETCH_SIZE	SIZE_M(16)
+#define PLAT_LAN966X_FIP_PREFETCH_BASE	(PLAT_LAN966X_NS_IMAGE_LIMIT - PLAT_LAN966X_FIP_PREFETCH_SIZE)
+
+/* BL33 is loaded below the prefetch scratch, so it can't overlap the FIP */
+#if MCHP_FIP_PREFETCH && defined(PLAT_LAN966X_FIP_PREFETCH_BASE)
+#define PLAT_LAN966X_BL33_MAX_SIZE	(PLAT_LAN966X_FIP_PREFETCH_BASE - PLAT_LAN966X_NS_IMAGE_BASE)
+#else
+#define PLAT_LAN966X_BL33_MAX_SIZE	PLAT_LAN966X_NS_IMAGE_SIZE
+#endif
+
 /*
  * Default FlexCom console
  */
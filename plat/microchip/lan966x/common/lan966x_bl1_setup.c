@@ -7,6 +7,7 @@
 #include <arch.h>
 #include <assert.h>
 #include <bl1/bl1.h>
+#include <boot_trace.h>
 #include <common/bl_common.h>
 #include <drivers/generic_delay_timer.h>
 #include <fw_config.h>
@@ -65,6 +66,8 @@ void bl1_early_platform_setup(void)
 	/* Enable arch timer */
 	generic_delay_timer_init();
 
+	boot_trace(BOOT_TRACE_BL1_START, 0);
+
 	/* Strapping */
 	lan966x_init_strapping();
 
@@ -170,8 +173,11 @@ int bl1_plat_handle_post_image_load(unsigned int image_id)
 	bl1_calc_bl2_mem_layout(&bl1_tzram_layout, &bl2_tzram_layout);
 	ep_info->args.arg1 = (uintptr_t)&bl2_tzram_layout;
 
+	boot_trace(BOOT_TRACE_IMAGE_DONE, image_id);
+
 	/* Shared memory info in arg2 */
 	shared_memory_desc.fw_config = &lan966x_fw_config;
+	shared_memory_desc.boot_trace = boot_trace_handoff();
 	flush_dcache_range((uintptr_t) &shared_memory_desc, sizeof(shared_memory_desc));
 	ep_info->args.arg2 = (uintptr_t) &shared_memory_desc;
 
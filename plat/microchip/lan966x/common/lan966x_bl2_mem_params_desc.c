@@ -80,7 +80,7 @@ static bl_mem_params_node_t bl2_mem_params_descs[] = {
 		SET_STATIC_PARAM_HEAD(image_info, PARAM_EP,
 				      VERSION_2, image_info_t, 0),
 		.image_info.image_base = PLAT_LAN966X_NS_IMAGE_BASE,
-		.image_info.image_max_size = PLAT_LAN966X_NS_IMAGE_SIZE,
+		.image_info.image_max_size = PLAT_LAN966X_BL33_MAX_SIZE,
 #endif /* PRELOADED_BL33_BASE */
 
 		.next_handoff_image_id = INVALID_IMAGE_ID,
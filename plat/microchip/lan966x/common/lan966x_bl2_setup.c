@@ -6,6 +6,7 @@
 
 #include <assert.h>
 
+#include <boot_trace.h>
 #include <common/bl_common.h>
 #include <drivers/generic_delay_timer.h>
 #include <drivers/microchip/otp.h>
@@ -84,6 +85,8 @@ static void bl2_early_platform_setup(void)
 	/* Enable arch timer */
 	generic_delay_timer_init();
 
+	boot_trace(BOOT_TRACE_BL2_START, 0);
+
 	/* Limit trace level if needed */
 	lan966x_set_max_trace_level();
 
@@ -107,6 +110,9 @@ void bl2_early_platform_setup2(u_register_t arg0, u_register_t arg1, u_register_
 
 	memcpy(&lan966x_fw_config, desc->fw_config, sizeof(lan966x_fw_config));
 
+	/* Continue the BL1 boot trace */
+	boot_trace_inherit(desc->boot_trace, BL1_RW_BASE, BL1_RW_LIMIT);
+
 	/* Forward mbedTLS heap */
 	lan966x_mbed_heap_set(desc);
 
@@ -177,7 +183,9 @@ void bl2_platform_setup(void)
 	lan966x_uvov_configure();
 
 	/* Initialize DDR for loading BL32/BL33 */
+	boot_trace(BOOT_TRACE_DDR_INIT, 0);
 	lan966x_ddr_init();
+	boot_trace(BOOT_TRACE_DDR_DONE, 0);
 
 #if defined(LAN966X_TZ)   /* N/A on LAN966X-A0 due to chip error */
 	/* Initialize the secure environment */
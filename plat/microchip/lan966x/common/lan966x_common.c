@@ -21,11 +21,13 @@
 #include <plat/common/platform.h>
 #include <platform_def.h>
 
+#include <lan966x_bootstrap.h>
 #include <lan96xx_mmc.h>
 #include <lan96xx_common.h>
 
 #include "lan966x_regs.h"
 #include "lan966x_private.h"
+#include "plat_otp.h"
 
 CASSERT((BL1_RW_SIZE + BL2_SIZE) <= LAN966X_SRAM_SIZE, assert_sram_depletion);
 
@@ -57,6 +59,12 @@ lan966x_fw_config_t lan966x_fw_config = {
 		LAN966X_DEV_SIZE,					\
 		MT_DEVICE | MT_RW | MT_SECURE)
 
+#define LAN966X_MAP_USB							\
+	MAP_REGION_FLAT(						\
+		LAN966X_USB_BASE,					\
+		LAN966X_USB_SIZE,					\
+		MT_DEVICE | MT_RW | MT_SECURE)
+
 #define LAN966X_MAP_BL32					\
 	MAP_REGION_FLAT(					\
 		BL32_BASE,					\
@@ -73,6 +81,7 @@ lan966x_fw_config_t lan966x_fw_config = {
 const mmap_region_t plat_arm_mmap[] = {
 	LAN966X_MAP_QSPI0,
 	LAN966X_MAP_AXI,
+	LAN966X_MAP_USB,
 	{0}
 };
 #endif
@@ -89,6 +98,7 @@ const mmap_region_t plat_arm_mmap[] = {
 const mmap_region_t plat_arm_mmap[] = {
 	LAN966X_MAP_QSPI0_RW,
 	LAN966X_MAP_AXI,
+	LAN966X_MAP_USB,
 	{0}
 };
 #endif
@@ -163,6 +173,39 @@ static void lan966x_flexcom_init(int idx)
 	lan966x_crash_console(&lan966x_console);
 }
 
+#if defined(IMAGE_BL1) || defined(IMAGE_BL2U)
+static void lan966x_usb_get_trim_values(struct usb_trim *trim)
+{
+	uint8_t trim_data[TRIM_SIZE];
+
+	memset(trim, 0, sizeof(*trim));
+
+	if (otp_read_trim(trim_data, sizeof(trim_data)) < 0)
+		return;		/* OTP read error? */
+
+	if (otp_all_zero(trim_data, sizeof(trim_data)))
+		return;		/* Nothing set */
+
+	trim->valid = true;
+	trim->bias = otp_read_com_bias_bg_mag_trim();
+	trim->rbias = otp_read_com_rbias_mag_trim();
+}
+
+/* The bootstrap monitor over USB CDC */
+static void lan966x_usb_console_init(void)
+{
+	struct usb_trim trim;
+
+	lan966x_usb_get_trim_values(&trim);
+	lan966x_usb_init(&trim);
+	lan966x_usb_register_console();
+
+	/* Send responses and receive payloads in whole bulk packets */
+	bootstrap_SetTxWrite(lan966x_usb_write_data);
+	bootstrap_SetRxRead(lan966x_usb_read_data);
+}
+#endif
+
 void lan966x_console_init(void)
 {
 	vcore_gpio_init(GCB_GPIO_OUT_SET(LAN966X_GCB_BASE));
@@ -188,6 +231,11 @@ void lan966x_console_init(void)
 	case LAN966X_STRAP_TFAMON_FC4:
 		lan966x_flexcom_init(FLEXCOM4);
 		break;
+#if defined(IMAGE_BL1) || defined(IMAGE_BL2U)
+	case LAN966X_STRAP_TFAMON_USB:
+		lan966x_usb_console_init();
+		break;
+#endif
 	default:
 		/* No console */
 		break;
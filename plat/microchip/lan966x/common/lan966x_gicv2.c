@@ -4,14 +4,18 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <common/interrupt_props.h>
 #include <drivers/arm/gicv2.h>
 #include <drivers/arm/gic_common.h>
+#include <drivers/delay_timer.h>
 #include <lib/utils.h>
 
 #include <platform_def.h>
 
+#include "lan966x_wait.h"
+
 /*
  * Define a list of Group 0 interrupts.
  */
@@ -25,7 +29,7 @@
  * List of interrupts.
  *****************************************************************************/
 static const interrupt_prop_t g0_interrupt_props[] = {
-	PLAT_LAN966X_GICV2_G0_IRQS
+	PLAT_LAN966X_GICV2_G0_IRQS,
 };
 
 static const gicv2_driver_data_t lan966x_gic_data = {
@@ -40,9 +44,38 @@ void plat_lan966x_gic_driver_init(void)
 	gicv2_driver_init(&lan966x_gic_data);
 }
 
+#if MCHP_WFI_WAIT
+/* Sleep granularity, bounding the wakeup latency */
+#define WAIT_TICK_US		50U
+
+/*
+ * Nap in WFI until the secure physical timer fires. Interrupts stay
+ * masked, the pending timer interrupt ends WFI all the same and is
+ * never taken.
+ */
+static void lan966x_gic_sleep(uint64_t deadline)
+{
+	uint64_t tick = timeout_init_us(WAIT_TICK_US);
+	u_register_t ctl = 0;
+
+	write_cntps_cval_el1(MIN(tick, deadline));
+	set_cntp_ctl_enable(ctl);
+	write_cntps_ctl_el1(ctl);
+
+	dsb();
+	wfi();
+
+	write_cntps_ctl_el1(0);
+}
+#endif
+
 void plat_lan966x_gic_init(void)
 {
 	gicv2_distif_init();
 	gicv2_pcpu_distif_init();
 	gicv2_cpuif_enable();
+
+#if MCHP_WFI_WAIT
+	lan966x_wait_set_sleep(lan966x_gic_sleep);
+#endif
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <boot_trace.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/desc_image_load.h>
@@ -27,6 +28,9 @@ void plat_flush_next_bl_params(void)
 	/* Flush BL params, as this hook normally does */
 	flush_bl_params_desc();
 
+	/* Boot trace of the last image loads, already handed to BL32 */
+	(void) boot_trace_handoff();
+
 	if (otp_read_bytes(OTP_REGION_ADDR(tbbr), sizeof(off_len), (void*) &off_len) == 0 &&
 	    off_len != 0 &&
 	    /* OTP emulation 'false' => ROTPK non-zero */
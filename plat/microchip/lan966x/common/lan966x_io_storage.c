@@ -11,6 +11,7 @@
 #include <platform_def.h>
 
 #include <arch_helpers.h>
+#include <boot_trace.h>
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/io/io_driver.h>
@@ -21,7 +22,9 @@
 #include <drivers/io/io_storage.h>
 #include <drivers/mmc.h>
 #include <drivers/partition/partition.h>
+#include <lan96xx_mmc.h>
 #include <lib/mmio.h>
+#include <otp_tags.h>
 #include <tools_share/firmware_image_package.h>
 #include <plat/common/platform.h>
 #include <common/desc_image_load.h>
@@ -105,6 +108,14 @@ static int fip_select;
 /* Data will be fetched from the GPT */
 static io_block_spec_t fip_mmc_block_spec;
 
+#if MCHP_FIP_PREFETCH && defined(IMAGE_BL2) && defined(PLAT_LAN966X_FIP_PREFETCH_BASE)
+#define FIP_PREFETCH
+/* Copy of the current FIP in DDR */
+static io_block_spec_t fip_prefetch_spec;
+static bool fip_prefetch_tried;
+static int fip_prefetch_select;
+#endif
+
 static io_block_spec_t fip_qspi_block_spec = {
 	.offset = LAN966X_QSPI0_MMAP,
 	.length = LAN966X_QSPI0_RANGE,
@@ -486,7 +497,25 @@ static int check_mmc_raw(const uintptr_t spec)
 	return result;
 }
 
-static int check_mmc(const uintptr_t spec)
+/*
+ * Point a FIP spec to its location. When the FIP moves, the ToC index
+ * io_fip keeps of it is stale.
+ */
+static void set_fip_spec(io_block_spec_t *spec, size_t offset, size_t length)
+{
+	if (spec->offset != offset || spec->length != length) {
+		spec->offset = offset;
+		spec->length = length;
+		fip_dev_invalidate_toc_index();
+#if defined(FIP_PREFETCH)
+		fip_prefetch_spec.length = 0;
+		fip_prefetch_tried = false;
+#endif
+	}
+}
+
+/* Point the MMC FIP spec to the partition of the current source */
+static int mmc_locate_fip(void)
 {
 	const partition_entry_t *entry;
 	const char *fipname;
@@ -511,11 +540,21 @@ static int check_mmc(const uintptr_t spec)
 		return -ENOTBLK;
 	}
 
-	fip_mmc_block_spec.offset = entry->start;
-	fip_mmc_block_spec.length = entry->length;
+	set_fip_spec(&fip_mmc_block_spec, entry->start, entry->length);
 
 	INFO("MMC: Try source %d, %s offset: %08x\n", fip_select, fipname, fip_mmc_block_spec.offset);
 
+	return 0;
+}
+
+static int check_mmc(const uintptr_t spec)
+{
+	int result;
+
+	result = mmc_locate_fip();
+	if (result != 0)
+		return result;
+
 	return check_mmc_raw(spec);
 }
 
@@ -528,7 +567,8 @@ static int check_memmap(const uintptr_t spec)
 	switch (fip_select) {
 	case FIP_SELECT_DEFAULT:
 		/* Start of flash */
-		fip_qspi_block_spec.offset = LAN966X_QSPI0_MMAP;
+		set_fip_spec(&fip_qspi_block_spec, LAN966X_QSPI0_MMAP,
+			     LAN966X_QSPI0_RANGE);
 		break;
 #if defined(IMAGE_BL2) && defined(LAN966X_DUAL_BL33)
 	case FIP_SELECT_NOR_NT_FIP1:
@@ -537,8 +577,9 @@ static int check_memmap(const uintptr_t spec)
 			return -EIO;
 		}
 	case FIP_SELECT_NOR_NT_FIP2:
-		fip_qspi_block_spec.offset =
-			nor_get_dual_fip_offset(fip_select == FIP_SELECT_NOR_NT_FIP1);
+		set_fip_spec(&fip_qspi_block_spec,
+			     nor_get_dual_fip_offset(fip_select == FIP_SELECT_NOR_NT_FIP1),
+			     LAN966X_QSPI0_RANGE);
 		break;
 #endif
 	default:
@@ -558,6 +599,81 @@ static int check_memmap(const uintptr_t spec)
 	return result;
 }
 
+#if defined(FIP_PREFETCH)
+static int check_fip_prefetch(const uintptr_t spec)
+{
+	int result;
+	uintptr_t local_image_handle;
+
+	result = io_dev_init(memmap_dev_handle, (uintptr_t)NULL);
+	if (result == 0) {
+		result = io_open(memmap_dev_handle, spec, &local_image_handle);
+		if (result == 0) {
+			VERBOSE("Using prefetched FIP\n");
+			io_close(local_image_handle);
+		}
+	}
+	return result;
+}
+
+static const struct plat_io_policy fip_prefetch_policy = {
+	&memmap_dev_handle,
+	(uintptr_t) &fip_prefetch_spec,
+	check_fip_prefetch
+};
+
+/*
+ * Read the current FIP into DDR with one large transfer, rather than
+ * seeking the device for each image. Only done once per FIP location.
+ */
+static bool fip_prefetch(void)
+{
+	size_t len;
+	int result;
+
+	switch (lan966x_get_boot_source()) {
+	case BOOT_SOURCE_EMMC:
+	case BOOT_SOURCE_SDMMC:
+		break;
+	default:
+		return false;
+	}
+
+	/* Only locate and fetch once per FIP selection, even if failing */
+	if (fip_prefetch_tried && fip_prefetch_select == fip_select)
+		return fip_prefetch_spec.length != 0;
+
+	/* Resets the prefetch state if the FIP moved */
+	result = mmc_locate_fip();
+
+	fip_prefetch_select = fip_select;
+	fip_prefetch_tried = true;
+
+	if (result != 0) {
+		/* Any copy held is not of this selection */
+		fip_prefetch_spec.length = 0;
+		return false;
+	}
+
+	if (fip_prefetch_spec.length != 0)
+		return true;
+
+	len = lan96xx_mmc_fip_prefetch(fip_mmc_block_spec.offset,
+				       fip_mmc_block_spec.length,
+				       PLAT_LAN966X_FIP_PREFETCH_BASE,
+				       PLAT_LAN966X_FIP_PREFETCH_SIZE);
+	if (len == 0) {
+		NOTICE("FIP prefetch failed, reading in place\n");
+		return false;
+	}
+
+	fip_prefetch_spec.offset = PLAT_LAN966X_FIP_PREFETCH_BASE;
+	fip_prefetch_spec.length = len;
+
+	return true;
+}
+#endif
+
 static int check_error(const uintptr_t spec)
 {
 	return -1;
@@ -638,6 +754,8 @@ bool ram_fip_valid(io_block_spec_t *spec)
 
 int bl1_plat_handle_pre_image_load(unsigned int image_id)
 {
+	boot_trace(BOOT_TRACE_IMAGE_LOAD, image_id);
+
 	/* Use RAM FIP only if defined */
 	fip_select =
 		ram_fip_valid(&ram_fip_spec) ?
@@ -658,6 +776,8 @@ int plat_try_next_boot_source(void)
 #elif defined(IMAGE_BL2)
 int bl2_plat_handle_pre_image_load(unsigned int image_id)
 {
+	boot_trace(BOOT_TRACE_IMAGE_LOAD, image_id);
+
 	fip_select = FIP_SELECT_DEFAULT;
 #if defined(LAN966X_DUAL_BL33)
 	if (lan966x_get_boot_source() == BOOT_SOURCE_QSPI) {
@@ -731,6 +851,10 @@ static const struct plat_io_policy *current_fip_io_policy(void)
 #if defined(IMAGE_BL1)
 	if (fip_select == FIP_SELECT_RAM_FIP)
 		return &boot_source_ram_fip;
+#endif
+#if defined(FIP_PREFETCH)
+	if (fip_prefetch())
+		return &fip_prefetch_policy;
 #endif
 	return &boot_source_policies[lan966x_get_boot_source()];
 }
@@ -777,6 +901,8 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 
 	assert(bl_mem_params);
 
+	boot_trace(BOOT_TRACE_IMAGE_DONE, image_id);
+
 	src = lan966x_get_boot_source();
 	switch (src) {
 	case BOOT_SOURCE_EMMC:
@@ -797,6 +923,8 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 		bl32_params.ddr_size = lan966x_ddr_size();
 		bl32_params.boot_offset = off;
 		bl32_params.bl2_version = PLAT_BL2_VERSION;
+		bl32_params.boot_trace = boot_trace_handoff();
+		bl32_params.otp_tags = otp_tag_handoff();
 		/* Pass bl32_params through GPR(3-5) */
 		mmio_write_32(CPU_GPR(LAN966X_CPU_BASE, 3), BL32_PTR_TAG);
 		mmio_write_32(CPU_GPR(LAN966X_CPU_BASE, 4), sizeof(bl32_params));
@@ -23,6 +23,7 @@ BL32_SOURCES            +=      drivers/microchip/crypto/aes.c			\
 				plat/microchip/common/lan966x_ns_enc.c		\
 				plat/microchip/common/lan966x_sip_svc.c		\
 				plat/microchip/common/lan966x_sjtag.c		\
+				plat/microchip/common/plat_fit.c		\
 				plat/microchip/lan966x/common/lan966x_tbbr.c
 
 BL32_SOURCES            +=      $(LIBFIT_SRCS)
@@ -4,11 +4,13 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <boot_trace.h>
 #include <common/debug.h>
 #include <common/desc_image_load.h>
 #include <drivers/generic_delay_timer.h>
 #include <drivers/microchip/tz_matrix.h>
 #include <errno.h>
+#include <stddef.h>
 #include <lib/mmio.h>
 #include <lib/xlat_tables/xlat_tables_compat.h>
 #include <plat/arm/common/plat_arm.h>
@@ -99,15 +101,18 @@ entry_point_info_t *sp_min_plat_get_bl33_ep_info(void)
 		return NULL;
 
 	if (fit_init_context(&fit, image->image_base) == EXIT_SUCCESS) {
+		boot_trace(BOOT_TRACE_FIT_START, 0);
 		INFO("Unpacking FIT image @ %p\n", fit.fit);
 		if (fit_select(&fit, fit_config_ptr) == EXIT_SUCCESS &&
 		    fit_load(&fit, FITIMG_PROP_DT_TYPE) == EXIT_SUCCESS &&
+		    fit_load(&fit, FITIMG_PROP_RAMDISK_TYPE) == EXIT_SUCCESS &&
 		    fit_load(&fit, FITIMG_PROP_KERNEL_TYPE) == EXIT_SUCCESS) {
 			/* Fixup DT, but allow to fail */
 			fit_fdt_update(&fit, PLAT_LAN966X_NS_IMAGE_BASE,
 				       mem_size,
 				       bootargs);
 			NOTICE("Preparing to boot 32-bit Linux kernel\n");
+			boot_trace(BOOT_TRACE_FIT_DONE, 0);
 			/*
 			 * According to the file ``Documentation/arm/Booting`` of the Linux
 			 * kernel tree, Linux expects:
@@ -121,6 +126,7 @@ entry_point_info_t *sp_min_plat_get_bl33_ep_info(void)
 			next_image_info->args.arg2 = fit.dtb;
 		} else {
 			ERROR("Unpacking FIT image for Linux failed\n");
+			boot_trace(BOOT_TRACE_FIT_DONE, 1);
 		}
 	} else {
 		NOTICE("Direct boot of BL33 binary image\n");
@@ -194,8 +200,10 @@ void params_early_setup(u_register_t plat_param_from_bl2)
 	/* Get bl2 fw_config (OTP EMU) */
 	memcpy(&lan966x_fw_config, src_config, sizeof(lan966x_fw_config));
 
+	/* Older BL2 may pass fewer members */
 	if (mmio_read_32(CPU_GPR(LAN966X_CPU_BASE, 3)) == BL32_PTR_TAG &&
-	    mmio_read_32(CPU_GPR(LAN966X_CPU_BASE, 4)) == sizeof(bl32_params_t)) {
+	    mmio_read_32(CPU_GPR(LAN966X_CPU_BASE, 4)) >= offsetof(bl32_params_t, boot_trace)) {
+		size_t size = mmio_read_32(CPU_GPR(LAN966X_CPU_BASE, 4));
 		bl32_params_t *bl32_params = (bl32_params_t *)
 			mmio_read_32(CPU_GPR(LAN966X_CPU_BASE, 5));
 
@@ -212,6 +220,14 @@ void params_early_setup(u_register_t plat_param_from_bl2)
 		/* Record bl2 version */
 		bl2_version = bl32_params->bl2_version;
 
+		/* Continue the BL2 boot trace */
+		if (size >= offsetof(bl32_params_t, otp_tags))
+			boot_trace_inherit(bl32_params->boot_trace, BL2_BASE, BL2_LIMIT);
+
+		/* OTP tags as read by BL2 */
+		if (size >= sizeof(bl32_params_t))
+			otp_tag_inherit(bl32_params->otp_tags, BL2_BASE, BL2_LIMIT);
+
 		/* Nuke GPR's, not used anymore */
 		mmio_write_32(CPU_GPR(LAN966X_CPU_BASE, 3), 0);
 		mmio_write_32(CPU_GPR(LAN966X_CPU_BASE, 4), 0);
@@ -248,6 +264,8 @@ void sp_min_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 
 	generic_delay_timer_init();
 
+	boot_trace(BOOT_TRACE_BL3X_START, 0);
+
 	/* Console */
 	lan966x_console_init();
 
@@ -332,6 +350,8 @@ static void configure_sram(void)
 
 void sp_min_plat_runtime_setup(void)
 {
+	boot_trace(BOOT_TRACE_BL33_START, 0);
+
 	/* Reset SRAM and allow NS access */
 	configure_sram();
 }
@@ -6,6 +6,7 @@
 
 include lib/xlat_tables_v2/xlat_tables.mk
 include drivers/arm/gic/v2/gicv2.mk
+include lib/lz4/lz4.mk
 include lib/zlib/zlib.mk
 include lib/libfit/libfit.mk
 include lib/libfdt/libfdt.mk
@@ -20,6 +21,38 @@ $(eval $(call add_define,MCHP_SOC_LAN969X))
 # Use QSPI pipelined XDMA
 $(eval $(call add_define,XDMAC_PIPELINE_SUPPPORT))
 
+# Nap in WFI between polls awaiting DMA/crypto completion in runtime services
+MCHP_WFI_WAIT		?= 0
+$(eval $(call add_define,MCHP_WFI_WAIT))
+
+# Read the whole FIP into DDR in one go when booting from eMMC/SD
+MCHP_FIP_PREFETCH	?= 0
+$(eval $(call add_define,MCHP_FIP_PREFETCH))
+
+# Record boot stage timestamps, readable through SiP
+MCHP_BOOT_TRACE		?= 1
+$(eval $(call add_define,MCHP_BOOT_TRACE))
+
+# QSPI NOR offset of a reserved sector to save DDR training results
+# in, skipping training on later boots. Disabled when empty.
+MCHP_DDR_TRAIN_QSPI_OFFSET	?=
+ifneq (${MCHP_DDR_TRAIN_QSPI_OFFSET},)
+$(eval $(call add_define,MCHP_DDR_TRAIN_QSPI_OFFSET))
+endif
+
+# With ECC, only initialize the first MCHP_DDR_ECC_INIT_MB of DDR, where
+# BL2 loads images, up front. The rest is initialized in the background
+# meanwhile, and BL31 awaits it before booting the NS world.
+MCHP_DDR_ECC_DEFERRED_INIT	?= 0
+$(eval $(call add_define,MCHP_DDR_ECC_DEFERRED_INIT))
+
+MCHP_DDR_ECC_INIT_MB		?= 64
+$(eval $(call add_define,MCHP_DDR_ECC_INIT_MB))
+
+# ECC patrol scrub interval, in SBRCTL.scrub_interval units. 0 disables.
+MCHP_DDR_ECC_SCRUB_INTERVAL	?= 0
+$(eval $(call add_define,MCHP_DDR_ECC_SCRUB_INTERVAL))
+
 LAN969X_PLAT		:=	plat/microchip/lan969x
 LAN969X_PLAT_BOARD	:=	${LAN969X_PLAT}/${PLAT}
 LAN969X_PLAT_COMMON	:=	${LAN969X_PLAT}/common
@@ -40,8 +73,10 @@ LAN969X_STORAGE_SOURCES	:=	drivers/io/io_block.c					\
 				drivers/io/io_storage.c					\
 				drivers/microchip/emmc/emmc.c				\
 				drivers/microchip/qspi/qspi_mtd.c			\
+				drivers/microchip/qspi/qspi_update.c			\
 				drivers/mmc/mmc.c					\
 				drivers/mtd/nor/spi_nor.c				\
+				drivers/mtd/nor/spi_nor_erase.c				\
 				drivers/mtd/spi-mem/spi_mem.c				\
 				drivers/partition/gpt.c					\
 				drivers/partition/partition.c				\
@@ -56,18 +91,21 @@ PLAT_BL_COMMON_SOURCES	:=	${FDT_WRAPPERS_SOURCES}			\
 				${LAN969X_PLAT_COMMON}/lan969x_tbbr.c	\
 				${LAN969X_CONSOLE_SOURCES}		\
 				${LAN969X_STORAGE_SOURCES}		\
+				$(LZ4_SOURCES)				\
 				$(ZLIB_SOURCES)				\
 				drivers/delay_timer/delay_timer.c	\
 				drivers/delay_timer/generic_delay_timer.c \
 				drivers/microchip/clock/lan966x_clock.c \
 				drivers/microchip/crypto/lan966x_sha.c	\
 				drivers/microchip/dma/xdmac.c		\
+				drivers/microchip/dma/xdmac_pipeline.c	\
 				drivers/microchip/otp/otp.c		\
 				drivers/microchip/trng/lan966x_trng.c	\
 				drivers/microchip/tz_matrix/tz_matrix.c	\
 				plat/microchip/common/duff_memcpy.c	\
 				plat/microchip/common/fw_config_dt.c	\
 				plat/microchip/common/lan966x_crc32.c	\
+				plat/microchip/common/lan966x_wait.c	\
 				plat/microchip/common/lan96xx_common.c	\
 				plat/microchip/common/plat_crypto.c	\
 				plat/microchip/common/plat_tbbr.c
@@ -83,6 +121,7 @@ BL1_SOURCES		+=	lib/cpus/aarch64/cortex_a53.S			\
 
 BL2_SOURCES		+=	common/desc_image_load.c			\
 				drivers/arm/tzc/tzc400.c			\
+				drivers/microchip/otp/otp_tags.c		\
 				drivers/microchip/pcie/lan969x_pcie_ep.c	\
 				${LAN969X_PLAT_COMMON}/lan969x_bl2_mem_params_desc.c \
 				${LAN969X_PLAT_COMMON}/lan969x_bl2_setup.c	\
@@ -139,10 +178,12 @@ BL31_SOURCES		+=	$(LIBFIT_SRCS)					\
 				plat/microchip/common/lan966x_ns_enc.c		\
 				plat/microchip/common/lan966x_sip_svc.c		\
 				plat/microchip/common/lan966x_sjtag.c		\
+				plat/microchip/common/plat_fit.c		\
 				plat/microchip/lan966x/common/lan966x_gicv2.c
 
-# libfit must support unzip
+# libfit must support unzip and lz4
 $(eval $(call add_define,MCHP_LIBFIT_GZIP))
+$(eval $(call add_define,MCHP_LIBFIT_LZ4))
 
 # We have/require TBB
 TRUSTED_BOARD_BOOT		:= 1
@@ -164,6 +205,17 @@ ifneq (${ENABLE_STACK_PROTECTOR},0)
 PLAT_BL_COMMON_SOURCES  +=      plat/microchip/common/lan966x_stack_protector.c
 endif
 
+ifneq (${MCHP_BOOT_TRACE},0)
+PLAT_BL_COMMON_SOURCES  +=      plat/microchip/common/boot_trace.c
+endif
+
+ifneq (${MCHP_DDR_TRAIN_QSPI_OFFSET},)
+BL2_SOURCES		+=	plat/microchip/common/ddr_train.c
+endif
+
+# Cortex-A53 has the optional ARMv8.0 CRC32 instructions (used for CRC32C)
+ARM_ARCH_FEATURE	:=	crc
+
 # Tune compiler for Cortex-A53
 ifeq ($(notdir $(CC)),armclang)
     TF_CFLAGS_aarch64	+=	-mcpu=cortex-a53
@@ -9,11 +9,14 @@
 
 #include <libfdt.h>
 #include <common/fdt_wrappers.h>
+#include <lib/cassert.h>
 #include <ddr_init.h>
 #include <ddr_platform.h>
 #include <ddr_reg.h>
 #include <ddr_test.h>
+#include <ddr_train.h>
 #include <ddr_xlist.h>
+#include <lan966x_crc32.h>
 #include <lan969x_ddr_clock.h>
 #include <platform_def.h>
 
@@ -31,6 +34,15 @@ char ddr_failure_details[132];
 
 static uint32_t ddr_size;
 
+#if MCHP_DDR_ECC_DEFERRED_INIT && defined(IMAGE_BL2) && !defined(LAN969X_LMSTAX)
+/* DDR initialized before BL2 continues, the image load area */
+#define ECC_INIT_SIZE	(PLAT_LAN969X_NS_LOAD_LIMIT - LAN969X_DDR_BASE)
+/* Only what is initialized can be tested */
+#define DDR_TEST_SIZE	(PLAT_LAN969X_NS_LOAD_LIMIT - PLAT_LAN969X_NS_IMAGE_BASE)
+#else
+#define DDR_TEST_SIZE	PLAT_LAN969X_NS_IMAGE_SIZE
+#endif
+
 static const struct {
 	uint32_t mask;
 	const char *desc;
@@ -80,6 +92,25 @@ static const struct reg_desc ddr_phy_timing_reg[] = {
 	XLIST_DDR_PHY_TIMING
 };
 
+/* PHY registers holding the data training results */
+static const uintptr_t ddr_train_reg[] = {
+#define TRAIN_REGS(n)							\
+	DDR_PHY_DX ## n ## BDLR0, DDR_PHY_DX ## n ## BDLR1,		\
+	DDR_PHY_DX ## n ## BDLR2, DDR_PHY_DX ## n ## BDLR3,		\
+	DDR_PHY_DX ## n ## BDLR4, DDR_PHY_DX ## n ## BDLR5,		\
+	DDR_PHY_DX ## n ## BDLR6, DDR_PHY_DX ## n ## BDLR7,		\
+	DDR_PHY_DX ## n ## BDLR8, DDR_PHY_DX ## n ## BDLR9,		\
+	DDR_PHY_DX ## n ## LCDLR0, DDR_PHY_DX ## n ## LCDLR1,		\
+	DDR_PHY_DX ## n ## LCDLR2, DDR_PHY_DX ## n ## LCDLR3,		\
+	DDR_PHY_DX ## n ## LCDLR4, DDR_PHY_DX ## n ## LCDLR5,		\
+	DDR_PHY_DX ## n ## MDLR0, DDR_PHY_DX ## n ## GTR0,		\
+	DDR_PHY_DX ## n ## GCR5, DDR_PHY_DX ## n ## GCR6
+	TRAIN_REGS(0),
+	TRAIN_REGS(1),
+#undef TRAIN_REGS
+};
+CASSERT(ARRAY_SIZE(ddr_train_reg) <= DDR_TRAIN_MAX_REGS, assert_ddr_train_reg_size);
+
 static inline bool deferred_register(uintptr_t reg)
 {
 	return reg == DDR_UMCTL2_SBRCTL; /* Only one special register so far */
@@ -263,15 +294,9 @@ static void axi_enable_ports(bool enable)
 	}
 }
 
-static int ecc_enable_scrubbing(const struct ddr_config *cfg)
+/* Start zero-filling [start, start + size) of DDR through the scrubber */
+static void ecc_scrub_start(uint32_t start, uint32_t size)
 {
-	uint32_t size = (cfg->info.size - 1) >> 1;
-
-	VERBOSE("Enable ECC scrubbing\n");
-
-	/* 1.  Disable AXI port. port_en = 0 */
-	axi_enable_ports(false);
-
 	/* 2. scrub_mode = 1 */
 	mmio_setbits_32(DDR_UMCTL2_SBRCTL, SBRCTL_SCRUB_MODE);
 
@@ -282,16 +307,19 @@ static int ecc_enable_scrubbing(const struct ddr_config *cfg)
 	mmio_write_32(DDR_UMCTL2_SBRWDATA0, 0);
 
 	/* 5. Address range */
-	mmio_write_32(DDR_UMCTL2_SBRSTART0, 0);
-	mmio_write_32(DDR_UMCTL2_SBRRANGE0, size); /* 16bit words */
+	mmio_write_32(DDR_UMCTL2_SBRSTART0, start >> 1);
+	mmio_write_32(DDR_UMCTL2_SBRRANGE0, (size - 1) >> 1); /* 16bit words */
 	mmio_write_32(DDR_UMCTL2_SBRSTART1, 0);
 	mmio_write_32(DDR_UMCTL2_SBRRANGE1, 0);
 
 	/* 6. Enable SBR programming */
 	mmio_setbits_32(DDR_UMCTL2_SBRCTL, SBRCTL_SCRUB_EN);
+}
 
+static int ecc_scrub_wait(int usec)
+{
 	/* 7. Poll SBRSTAT.scrub_done */
-	if (wait_reg_set(DDR_UMCTL2_SBRSTAT, SBRSTAT_SCRUB_DONE, 10000000)) {
+	if (wait_reg_set(DDR_UMCTL2_SBRSTAT, SBRSTAT_SCRUB_DONE, usec)) {
 		DDR_FAILURE("Timeout: SBRSTAT.done not set: 0x%0x\n",
 			    mmio_read_32(DDR_UMCTL2_SBRSTAT));
 		return -ETIMEDOUT;
@@ -307,20 +335,68 @@ static int ecc_enable_scrubbing(const struct ddr_config *cfg)
 	/* 9. Disable SBR programming */
 	mmio_clrbits_32(DDR_UMCTL2_SBRCTL, SBRCTL_SCRUB_EN);
 
-	VERBOSE("Initial ECC scrubbing done\n");
+	return 0;
+}
 
-#if 0
-	/* 10+11: Enable SBR programming again if enabled and interval != 0 */
-	if (cfg->main.sbrctl & SBRCTL_SCRUB_EN &&
-	    FIELD_GET(SBRCTL_SCRUB_INTERVAL, cfg->main.sbrctl) != 0) {
-		mmio_write_32(DDR_UMCTL2_SBRCTL, cfg->main.sbrctl);
+static void ecc_patrol_enable(void)
+{
+	/* 10+11: Enable SBR programming again if interval != 0 */
+	if (MCHP_DDR_ECC_SCRUB_INTERVAL != 0) {
+		mmio_write_32(DDR_UMCTL2_SBRCTL,
+			      FIELD_PREP(SBRCTL_SCRUB_INTERVAL,
+					 MCHP_DDR_ECC_SCRUB_INTERVAL) |
+			      SBRCTL_SCRUB_EN);
 		VERBOSE("Enabled ECC scrubbing\n");
 	}
+}
+
+static int ecc_enable_scrubbing(const struct ddr_config *cfg)
+{
+	uint32_t size = cfg->info.size;
+	int ret;
+
+	VERBOSE("Enable ECC scrubbing\n");
+
+#if defined(ECC_INIT_SIZE)
+	/* Only where BL2 loads images, the rest comes later */
+	size = MIN(size, (uint32_t) ECC_INIT_SIZE);
 #endif
 
+	/* 1.  Disable AXI port. port_en = 0 */
+	axi_enable_ports(false);
+
+	/* 2-6. Zero-fill */
+	ecc_scrub_start(0, size);
+
+	/* 7-9. Await completion */
+	ret = ecc_scrub_wait(10000000);
+	if (ret)
+		return ret;
+
+	VERBOSE("Initial ECC scrubbing done\n");
+
+	if (size == cfg->info.size)
+		ecc_patrol_enable();
+
 	/* 12. Enable AXI port */
 	axi_enable_ports(true);
 
+#if defined(ECC_INIT_SIZE)
+	/*
+	 * Fill the rest while images are loaded, with the AXI ports
+	 * enabled. The controller arbitrates scrubber and port requests,
+	 * so traffic below the range is unaffected. Nothing may access the
+	 * range until the fill is done: BL2 loads images below it only
+	 * (BL33 is limited to PLAT_LAN969X_BL33_MAX_SIZE), and BL31 awaits
+	 * completion before using it or starting the NS world.
+	 */
+	if (size < cfg->info.size) {
+		ecc_scrub_start(size, cfg->info.size - size);
+		INFO("DDR: ECC init of %d MiB deferred\n",
+		     (cfg->info.size - size) / 1024 / 1024);
+	}
+#endif
+
 	return 0;
 }
 
@@ -477,6 +553,32 @@ static void VREF_Training_Setup(void)
 			   VTCR1_ENUM | FIELD_PREP(VTCR1_HVSS, 1) | FIELD_PREP(VTCR1_VWCR, 0xF));
 }
 
+/* Common end of training: normal refresh, updates and AXI ports back on */
+static void data_training_finish(const struct ddr_config *cfg)
+{
+	ddr_restore_refresh(cfg->main.rfshctl3, cfg->main.pwrctl);
+
+	/* Reenabling uMCTL2 initiated update request after executing
+	 * DDR initization. Reference: DDR4 MultiPHY PUB databook
+	 * (3.11a) PIR.INIT description (pg no. 114)
+	 */
+	sw_done_start();
+	mmio_clrbits_32(DDR_UMCTL2_DFIUPD0, DFIUPD0_DIS_AUTO_CTRLUPD);
+	sw_done_ack();
+
+	/* Reenabling PHY update Request after executing DDR
+	 * initization. Reference: DDR4 MultiPHY PUB databook (3.11a)
+	 * PIR.INIT description (pg no. 114)
+	 */
+	mmio_setbits_32(DDR_PHY_DSGCR, DSGCR_PUREN);
+
+	/* Enable AXI port(s) */
+	axi_enable_ports(true);
+
+	/* Settle */
+	ddr_usleep(1);
+}
+
 static int do_data_training(const struct ddr_config *cfg)
 {
 	bool ddr4 = !!(cfg->main.mstr & MSTR_DDR4);
@@ -549,45 +651,60 @@ static int do_data_training(const struct ddr_config *cfg)
 		return -EIO;
 	}
 
-	ddr_restore_refresh(cfg->main.rfshctl3, cfg->main.pwrctl);
+	data_training_finish(cfg);
 
-	/* Reenabling uMCTL2 initiated update request after executing
-	 * DDR initization. Reference: DDR4 MultiPHY PUB databook
-	 * (3.11a) PIR.INIT description (pg no. 114)
-	 */
-	sw_done_start();
-	mmio_clrbits_32(DDR_UMCTL2_DFIUPD0, DFIUPD0_DIS_AUTO_CTRLUPD);
-	sw_done_ack();
+	VERBOSE("do_data_training:exit\n");
 
-	/* Reenabling PHY update Request after executing DDR
-	 * initization. Reference: DDR4 MultiPHY PUB databook (3.11a)
-	 * PIR.INIT description (pg no. 114)
-	 */
-	mmio_setbits_32(DDR_PHY_DSGCR, DSGCR_PUREN);
+	return 0;
+}
 
-	/* Enable AXI port(s) */
-	axi_enable_ports(true);
+/*
+ * Instead of training, load the delays found by an earlier training
+ * of the same configuration.
+ */
+static void restore_data_training(const struct ddr_config *cfg,
+				  const struct ddr_train_record *rec)
+{
+	int i;
 
-	/* Settle */
-	ddr_usleep(1);
+	VERBOSE("restore_data_training:enter\n");
 
-	VERBOSE("do_data_training:exit\n");
+	/* Disable Auto refresh and power down while changing delays */
+	ddr_disable_refresh();
 
-	return 0;
+	for (i = 0; i < ARRAY_SIZE(ddr_train_reg); i++)
+		mmio_write_32(ddr_train_reg[i], rec->regs[i]);
+
+	/* The delays were trained in static read mode */
+	mmio_clrsetbits_32(DDR_PHY_PGCR3, PGCR3_RDMODE,
+			   FIELD_PREP(PGCR3_RDMODE, 1));
+
+	/* PHY FIFO reset - as recommended in PUB databook */
+	phy_fifo_reset();
+
+	data_training_finish(cfg);
+
+	VERBOSE("restore_data_training:exit\n");
 }
 
-int ddr_init(const struct ddr_config *cfg)
+static void save_data_training(uint32_t cfg_crc)
 {
-	int ret;
+	struct ddr_train_record rec = {
+		.cfg_crc = cfg_crc,
+		.nregs = ARRAY_SIZE(ddr_train_reg),
+	};
+	int i;
 
-	strlcpy(ddr_failure_details, "No error", sizeof(ddr_failure_details));
+	for (i = 0; i < ARRAY_SIZE(ddr_train_reg); i++)
+		rec.regs[i] = mmio_read_32(ddr_train_reg[i]);
 
-	VERBOSE("ddr_init:start\n");
+	ddr_train_save(&rec);
+}
 
-	NOTICE("DDR: %s, %d MHz, %dMiB, ECC %s\n", cfg->info.name,
-	       cfg->info.speed,
-	       cfg->info.size / 1024 / 1024,
-	       cfg->main.ecccfg0 & ECCCFG0_ECC_MODE ? "enabled" : "disabled");
+static int ddr_start(const struct ddr_config *cfg,
+		     const struct ddr_train_record *rec)
+{
+	int ret;
 
 	/* Reset, start clocks at desired speed */
 	ret = ddr_reset(cfg, true);
@@ -646,7 +763,9 @@ int ddr_init(const struct ddr_config *cfg)
 	/* wait 2ms for STAT.operating_mode to become "normal" */
 	wait_operating_mode(1, TIME_MS_TO_US(2U));
 
-	if (do_data_training(cfg)) {
+	if (rec != NULL) {
+		restore_data_training(cfg, rec);
+	} else if (do_data_training(cfg)) {
 		ERROR("Data training failed\n");
 		return -EIO;
 	}
@@ -658,6 +777,54 @@ int ddr_init(const struct ddr_config *cfg)
 		}
 	}
 
+	return 0;
+}
+
+/* Quick check of restored training, before trusting it */
+static bool ddr_train_valid(void)
+{
+	return ddr_test_data_bus(PLAT_LAN969X_NS_IMAGE_BASE, true) == 0 &&
+		ddr_test_addr_bus(PLAT_LAN969X_NS_IMAGE_BASE,
+				  DDR_TEST_SIZE, true) == 0;
+}
+
+int ddr_init(const struct ddr_config *cfg)
+{
+	struct ddr_train_record rec;
+	uint32_t cfg_crc = 0;
+	int ret;
+
+	strlcpy(ddr_failure_details, "No error", sizeof(ddr_failure_details));
+
+	VERBOSE("ddr_init:start\n");
+
+	NOTICE("DDR: %s, %d MHz, %dMiB, ECC %s\n", cfg->info.name,
+	       cfg->info.speed,
+	       cfg->info.size / 1024 / 1024,
+	       cfg->main.ecccfg0 & ECCCFG0_ECC_MODE ? "enabled" : "disabled");
+
+	if (DDR_TRAIN_CACHE) {
+		cfg_crc = Crc32c(0, cfg, sizeof(*cfg));
+
+		/* Skip training if an earlier result still works */
+		if (ddr_train_load(cfg_crc, ARRAY_SIZE(ddr_train_reg), &rec)) {
+			if (ddr_start(cfg, &rec) == 0 && ddr_train_valid()) {
+				INFO("DDR: Using saved training\n");
+				VERBOSE("ddr_init:done\n");
+				return 0;
+			}
+			NOTICE("DDR: Saved training failed, retraining\n");
+			strlcpy(ddr_failure_details, "No error", sizeof(ddr_failure_details));
+		}
+	}
+
+	ret = ddr_start(cfg, NULL);
+	if (ret)
+		return ret;
+
+	if (DDR_TRAIN_CACHE)
+		save_data_training(cfg_crc);
+
 	VERBOSE("ddr_init:done\n");
 
 	return 0;
@@ -785,7 +952,7 @@ void lan966x_ddr_init(void *fdt)
 	if (err_off != 0)
 		PANIC("DDR data bus test @ 0x%08lx\n", err_off);
 
-	err_off = ddr_test_addr_bus(PLAT_LAN969X_NS_IMAGE_BASE, PLAT_LAN969X_NS_IMAGE_SIZE, true);
+	err_off = ddr_test_addr_bus(PLAT_LAN969X_NS_IMAGE_BASE, DDR_TEST_SIZE, true);
 	if (err_off != 0)
 		PANIC("DDR address bus test @ 0x%08lx\n", err_off);
 
@@ -8,6 +8,7 @@
 
 #include <arch.h>
 #include <bl1/bl1.h>
+#include <boot_trace.h>
 #include <common/bl_common.h>
 #include <drivers/generic_delay_timer.h>
 #include <drivers/microchip/otp.h>
@@ -68,6 +69,8 @@ void bl1_early_platform_setup(void)
 	/* Enable arch timer */
 	generic_delay_timer_init();
 
+	boot_trace(BOOT_TRACE_BL1_START, 0);
+
 	/* Strapping */
 	lan966x_init_strapping();
 
@@ -178,5 +181,9 @@ int bl1_plat_handle_post_image_load(unsigned int image_id)
 	ep_info->args.arg2 = (uintptr_t) &lan966x_fw_config;
 	flush_dcache_range(ep_info->args.arg2, sizeof(lan966x_fw_config));
 
+	/* Boot trace in arg3 */
+	boot_trace(BOOT_TRACE_IMAGE_DONE, image_id);
+	ep_info->args.arg3 = boot_trace_handoff();
+
 	return 0;
 }
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 
+#include <boot_trace.h>
 #include <common/bl_common.h>
 #include <common/desc_image_load.h>
 #include <drivers/generic_delay_timer.h>
@@ -92,6 +93,8 @@ static void bl2_early_platform_setup(void)
 	/* Enable arch timer */
 	generic_delay_timer_init();
 
+	boot_trace(BOOT_TRACE_BL2_START, 0);
+
 	/* Set logging level */
 	lan969x_set_max_trace_level();
 
@@ -111,6 +114,9 @@ void bl2_early_platform_setup2(u_register_t arg0, u_register_t arg1, u_register_
 	/* Shared data */
 	memcpy(&lan966x_fw_config, (const void *) arg2, sizeof(lan966x_fw_config));
 
+	/* Continue the BL1 boot trace */
+	boot_trace_inherit(arg3, BL1_RW_BASE, BL1_RW_LIMIT);
+
 	/* Common setup */
 	bl2_early_platform_setup();
 }
@@ -148,7 +154,9 @@ void bl2_platform_setup(void)
 
 #if !defined(LAN969X_LMSTAX)
 	/* Init DDR */
+	boot_trace(BOOT_TRACE_DDR_INIT, 0);
 	lan966x_ddr_init(lan966x_get_dt());
+	boot_trace(BOOT_TRACE_DDR_DONE, 0);
 
 	/* Init PCIe Endpoint */
 	lan969x_pcie_ep_init(lan966x_get_dt());
@@ -163,6 +171,9 @@ void plat_flush_next_bl_params(void)
 {
 	flush_bl_params_desc();
 
+	/* Boot trace of the last image loads, already handed to BL31 */
+	(void) boot_trace_handoff();
+
 	/* Last TZPM settings */
 	VERBOSE("Enable last NS devices\n");
 	lan969x_tz_finish();
@@ -233,6 +233,7 @@ static int fip_update(const char *name, uintptr_t buf_ptr, uint32_t len, bool ve
 	const partition_entry_t *entry = get_partition_entry(name);
 
 	if (entry) {
+		struct qspi_update_stats st;
 		int ret;
 		if (len > entry->length) {
 			NOTICE("Partition %s only can hold %d bytes, %d uploaded\n",
@@ -246,9 +247,12 @@ static int fip_update(const char *name, uintptr_t buf_ptr, uint32_t len, bool ve
 			break;
 		case BOOT_SOURCE_QSPI:
 			NOTICE("QSPI: Fip update '%s' @ %08lx, len %d\n", name, entry->start, len);
-			ret = qspi_write(entry->start, (void*) buf_ptr, len);
-			if (ret == 0)
+			ret = qspi_update(entry->start, (void*) buf_ptr, len, &st);
+			if (ret == 0) {
+				NOTICE("QSPI: Fip update '%s': %d sectors rewritten, %d blank programmed, %d unchanged\n",
+				       name, st.rewritten, st.programmed, st.skipped);
 				ret = lan966x_bl2u_qspi_verify(entry->start, buf_ptr, len);
+			}
 			NOTICE("QSPI: Fip update '%s': ret %d\n", name, ret);
 			break;
 		default:
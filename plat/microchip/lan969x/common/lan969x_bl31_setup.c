@@ -6,9 +6,13 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stddef.h>
 #include <lib/smccc.h>
 
+#include <boot_trace.h>
 #include <common/bl_common.h>
+#include <ddr_reg.h>
+#include <drivers/delay_timer.h>
 #include <drivers/generic_delay_timer.h>
 #include <drivers/microchip/tz_matrix.h>
 #include <lib/mmio.h>
@@ -17,13 +21,10 @@
 #include <plat/arm/common/plat_arm.h>
 #include <plat/common/platform.h>
 #include <plat/microchip/common/lan966x_gic.h>
-#include <tf_gunzip.h>
 
 #include "lan969x_private.h"
 #include <otp_tags.h>
 
-#define PAGE_ALIGN(x, a)	(((x) + (a) - 1) & ~((a) - 1))
-
 static entry_point_info_t bl32_image_ep_info;
 static entry_point_info_t bl33_image_ep_info;
 static uintptr_t bl33_image_base;
@@ -116,7 +117,9 @@ int fit_plat_default_address(const struct fit_context *fit, fit_prop_t prop, uin
 		break;
 
 	case FITIMG_PROP_RAMDISK_TYPE:
-		*addr = PLAT_LAN969X_NS_IMAGE_BASE + SIZE_M(32);
+		/* Clear of the FIT, which may be larger than 32MiB */
+		*addr = MAX(PLAT_LAN969X_NS_IMAGE_BASE + SIZE_M(32),
+			    round_up(fit_scratch_end(fit), SIZE_M(1)));
 		break;
 
 	default:
@@ -132,34 +135,39 @@ int fit_plat_default_address(const struct fit_context *fit, fit_prop_t prop, uin
 	return ret;
 }
 
-int fit_plat_uncompress(const struct fit_context *fit, uintptr_t dst,
-			uintptr_t src, size_t src_len, size_t *output_len)
+#if MCHP_DDR_ECC_DEFERRED_INIT && !defined(LAN969X_LMSTAX)
+/*
+ * BL2 leaves the ECC initialization of DDR above its image load area
+ * running, the scrubber in write (init) mode. Await it before that
+ * memory is used, then start the patrol scrubbing held back by it.
+ */
+static void lan969x_ddr_ecc_finish(void)
 {
-	uintptr_t work_buf, out_buf, out_start, out_limit;
-	size_t work_len;
-	int ret;
-
-	/* Set up decompress params */
-	work_buf = (uintptr_t) fit->fit + fit_size(fit);
-	work_buf = PAGE_ALIGN(work_buf, SIZE_M(1));
-	work_len = SIZE_M(16);
-	out_start = out_buf = work_buf + work_len;
-	ret = fit_plat_default_address(fit, FITIMG_PROP_DT_TYPE, &out_limit);
-	if (ret)
-		return ret;
-	INFO("Unzip(src %08lx, src_len %zd, out %08lx, out_len %zd, work %08lx, work_len %zd)\n",
-	     src, src_len, out_buf, out_limit - out_start, work_buf, work_len);
-	ret = gunzip(&src, src_len, &out_buf, out_limit - out_start, work_buf, work_len);
-	if (ret == 0) {
-		size_t out_len = out_buf - out_start;
-		/* Move into place */
-		memcpy((void*) dst, (void*) out_start, out_len);
-		INFO("Uncompressed data, length now %zd bytes\n", out_len);
-		*output_len = out_len;
+	const uint32_t init = SBRCTL_SCRUB_EN | SBRCTL_SCRUB_MODE;
+	uint64_t t;
+
+	if ((mmio_read_32(DDR_UMCTL2_SBRCTL) & init) != init)
+		return;
+
+	t = timeout_init_us(10000000);
+	while ((mmio_read_32(DDR_UMCTL2_SBRSTAT) & SBRSTAT_SCRUB_DONE) == 0 ||
+	       (mmio_read_32(DDR_UMCTL2_SBRSTAT) & SBRSTAT_SCRUB_BUSY) != 0) {
+		if (timeout_elapsed(t))
+			PANIC("DDR ECC initialization timeout: 0x%0x\n",
+			      mmio_read_32(DDR_UMCTL2_SBRSTAT));
 	}
 
-	return ret;
+	mmio_clrbits_32(DDR_UMCTL2_SBRCTL, SBRCTL_SCRUB_EN);
+
+	if (MCHP_DDR_ECC_SCRUB_INTERVAL != 0)
+		mmio_write_32(DDR_UMCTL2_SBRCTL,
+			      FIELD_PREP(SBRCTL_SCRUB_INTERVAL,
+					 MCHP_DDR_ECC_SCRUB_INTERVAL) |
+			      SBRCTL_SCRUB_EN);
+
+	VERBOSE("Deferred ECC scrubbing done\n");
 }
+#endif
 
 void bl31_fit_unpack(void)
 {
@@ -167,6 +175,7 @@ void bl31_fit_unpack(void)
 	struct fit_context fit;
 
 	if (fit_init_context(&fit, bl33_image_base) == EXIT_SUCCESS) {
+		boot_trace(BOOT_TRACE_FIT_START, 0);
 		INFO("Unpacking FIT image @ %p\n", fit.fit);
 		/* Get FIT config name from OTP */
 		if (otp_tag_get_string(otp_tag_type_fit_config, fit_config, sizeof(fit_config)) > 0)
@@ -175,12 +184,14 @@ void bl31_fit_unpack(void)
 			fit_config_ptr = "lan9698_ev23x71a_0_at_lan969x";
 		if (fit_select(&fit, fit_config_ptr) == EXIT_SUCCESS &&
 		    fit_load(&fit, FITIMG_PROP_DT_TYPE) == EXIT_SUCCESS &&
+		    fit_load(&fit, FITIMG_PROP_RAMDISK_TYPE) == EXIT_SUCCESS &&
 		    fit_load(&fit, FITIMG_PROP_KERNEL_TYPE) == EXIT_SUCCESS) {
 			/* Fixup DT, but allow to fail */
 			fit_fdt_update(&fit, PLAT_LAN969X_NS_IMAGE_BASE,
 				       bl31_params.ddr_size,
 				       bootargs);
 			NOTICE("Preparing to boot 64-bit Linux kernel\n");
+			boot_trace(BOOT_TRACE_FIT_DONE, 0);
 			/*
 			 * According to the file ``Documentation/arm64/booting.txt`` of the
 			 * Linux kernel tree, Linux expects the physical address of the device
@@ -193,6 +204,7 @@ void bl31_fit_unpack(void)
 			bl33_image_ep_info.args.arg3 = 0ULL;
 		} else {
 			ERROR("Unpacking FIT image for Linux failed\n");
+			boot_trace(BOOT_TRACE_FIT_DONE, 1);
 		}
 	} else {
 		NOTICE("Direct boot of BL33 binary image\n");
@@ -205,18 +217,27 @@ void bl31_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 	void *from_bl2 = (void *) arg0;
 	bl31_params_t *params_bl2 = (bl31_params_t *) arg1;
 
-	/* Save bl31 params */
+	/* Save bl31 params, older BL2 may pass fewer members */
 	if (params_bl2 &&
 	    params_bl2->magic == BL31_MAGIC_TAG &&
-	    params_bl2->size == sizeof(bl31_params_t))
-		bl31_params = *params_bl2;
+	    params_bl2->size >= offsetof(bl31_params_t, boot_trace) &&
+	    params_bl2->size <= sizeof(bl31_params_t))
+		memcpy(&bl31_params, params_bl2, params_bl2->size);
 	else {
 		bl31_params.ddr_size = PLAT_LAN969X_NS_IMAGE_SIZE;
 	}
 
+	/* Continue the BL2 boot trace, BL2 memory is wiped later */
+	boot_trace_inherit(bl31_params.boot_trace, BL2_BASE, BL2_LIMIT);
+
+	/* OTP tags as read by BL2 */
+	otp_tag_inherit(bl31_params.otp_tags, BL2_BASE, BL2_LIMIT);
+
 	/* Enable arch timer */
 	generic_delay_timer_init();
 
+	boot_trace(BOOT_TRACE_BL3X_START, 0);
+
 	/* Set logging level */
 	lan969x_set_max_trace_level();
 
@@ -274,6 +295,11 @@ void bl31_platform_setup(void)
 	plat_lan966x_gic_driver_init();
 	plat_lan966x_gic_init();
 
+#if MCHP_DDR_ECC_DEFERRED_INIT && !defined(LAN969X_LMSTAX)
+	/* All of DDR is used from here */
+	lan969x_ddr_ecc_finish();
+#endif
+
 	/* See if FIT needs to be moved around */
 	bl31_fit_unpack();
 }
@@ -297,6 +323,8 @@ void bl31_plat_runtime_setup(void)
 
 	INFO("NS Runtime initialization performed now\n");
 
+	boot_trace(BOOT_TRACE_BL33_START, 0);
+
 	/* Wipe re-purposed SRAM */
 	memset((void *)BL2_BASE, 0, BL2_SIZE);
 	flush_dcache_range((uintptr_t)BL2_BASE, BL2_SIZE);
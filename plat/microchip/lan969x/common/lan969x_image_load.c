@@ -5,12 +5,14 @@
  */
 
 #include <assert.h>
+#include <boot_trace.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/desc_image_load.h>
 #include <common/fdt_wrappers.h>
 #include <lib/mmio.h>
 #include <libfdt.h>
+#include <otp_tags.h>
 #include <plat/common/platform.h>
 
 #include "lan969x_regs.h"
@@ -37,6 +39,13 @@ static int plat_get_board(void *fdt)
 	return fdt_read_uint32_default(fdt, offs, "board-number", 0);
 }
 
+int bl2_plat_handle_post_image_load(unsigned int image_id)
+{
+	boot_trace(BOOT_TRACE_IMAGE_DONE, image_id);
+
+	return 0;
+}
+
 /*******************************************************************************
  * This function returns the list of loadable images.
  ******************************************************************************/
@@ -66,6 +75,8 @@ bl_params_t *plat_get_next_bl_params(void)
 	bl31_params.board_number = plat_get_board(lan966x_get_dt());
 	bl31_params.boot_offset = lan966x_get_boot_offset();
 	bl31_params.bl2_version = PLAT_BL2_VERSION;
+	bl31_params.boot_trace = boot_trace_handoff();
+	bl31_params.otp_tags = otp_tag_handoff();
 	ep_info->args.arg1 = (uintptr_t) &bl31_params;
 	/* Passed between contexts */
 	flush_dcache_range(ep_info->args.arg1, sizeof(bl31_params));
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <arch_helpers.h>
+#include <boot_trace.h>
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/io/io_block.h>
@@ -23,6 +24,7 @@
 #include <drivers/mmc.h>
 #include <drivers/partition/partition.h>
 #include <drivers/spi_nor.h>
+#include <lan96xx_mmc.h>
 #include <lib/fconf/fconf_tbbr_getter.h>
 #include <lib/mmio.h>
 #include <plat/common/platform.h>
@@ -103,6 +105,13 @@ static bool fip_spec_valid;
 /* Data will be fetched from the GPT */
 static io_block_spec_t fip_block_spec;
 
+#if MCHP_FIP_PREFETCH && defined(IMAGE_BL2) && defined(PLAT_LAN969X_FIP_PREFETCH_BASE)
+#define FIP_PREFETCH
+/* Copy of the current FIP in DDR */
+static io_block_spec_t fip_prefetch_spec;
+static bool fip_prefetch_tried;
+#endif
+
 static const io_block_spec_t mmc_gpt_spec = {
 	.offset	= LAN966X_GPT_BASE,
 	.length	= LAN966X_GPT_SIZE,
@@ -452,6 +461,23 @@ natural:
 }
 #endif
 
+/*
+ * Point a FIP spec to its location. When the FIP moves, the ToC index
+ * io_fip keeps of it is stale.
+ */
+static void set_fip_spec(io_block_spec_t *spec, size_t offset, size_t length)
+{
+	if (spec->offset != offset || spec->length != length) {
+		spec->offset = offset;
+		spec->length = length;
+		fip_dev_invalidate_toc_index();
+#if defined(FIP_PREFETCH)
+		fip_prefetch_spec.length = 0;
+		fip_prefetch_tried = false;
+#endif
+	}
+}
+
 static bool lan969x_get_fip_addr(int fip_src)
 {
 	const char *name;
@@ -464,15 +490,15 @@ static bool lan969x_get_fip_addr(int fip_src)
 	case FIP_SELECT_RAW:
 		/* Try to use non-gpt fallback values */
 		NOTICE("Assuming FIP start at device origin\n");
-		fip_block_spec.offset = 0;
-		fip_block_spec.length = SIZE_M(2); /* Conservative default */
+		set_fip_spec(&fip_block_spec, 0, SIZE_M(2)); /* Conservative default */
 		return true;
 
 #if defined(IMAGE_BL2) && defined(LAN969X_LMSTAX)
 	case FIP_SELECT_NOR_NT_FIP1:
 	case FIP_SELECT_NOR_NT_FIP2:
-		fip_block_spec.offset = nor_get_dual_fip_offset(fip_src == FIP_SELECT_NOR_NT_FIP1);
-		fip_block_spec.length = NT_FIP_SIZE;
+		set_fip_spec(&fip_block_spec,
+			     nor_get_dual_fip_offset(fip_src == FIP_SELECT_NOR_NT_FIP1),
+			     NT_FIP_SIZE);
 		NOTICE("Try FIP at offset %08zx\n", fip_block_spec.offset);
 		return true;
 #endif
@@ -493,8 +519,7 @@ static bool lan969x_get_fip_addr(int fip_src)
 	INFO("Found partition '%s' at offset 0x%0lx length %ld\n",
 	     name, entry->start, entry->length);
 
-	fip_block_spec.offset = entry->start;
-	fip_block_spec.length = entry->length;
+	set_fip_spec(&fip_block_spec, entry->start, entry->length);
 
 	return true;
 }
@@ -532,6 +557,68 @@ static const struct plat_io_policy boot_source_ram_fip = {
 };
 #endif
 
+#if defined(FIP_PREFETCH)
+static int check_fip_prefetch(const uintptr_t spec)
+{
+	int result;
+	uintptr_t local_image_handle;
+
+	result = io_dev_init(memmap_dev_handle, (uintptr_t)NULL);
+	if (result == 0) {
+		result = io_open(memmap_dev_handle, spec, &local_image_handle);
+		if (result == 0) {
+			VERBOSE("Using prefetched FIP\n");
+			io_close(local_image_handle);
+		}
+	}
+	return result;
+}
+
+static const struct plat_io_policy fip_prefetch_policy = {
+	&memmap_dev_handle,
+	(uintptr_t) &fip_prefetch_spec,
+	check_fip_prefetch
+};
+
+/*
+ * Read the current FIP into DDR with one large transfer, rather than
+ * seeking the device for each image. Only done once per FIP location.
+ */
+static bool fip_prefetch(void)
+{
+	size_t len;
+
+	if (fip_prefetch_spec.length != 0)
+		return true;
+
+	if (fip_prefetch_tried || !fip_spec_valid)
+		return false;
+
+	switch (lan966x_get_boot_source()) {
+	case BOOT_SOURCE_EMMC:
+	case BOOT_SOURCE_SDMMC:
+		break;
+	default:
+		return false;
+	}
+
+	fip_prefetch_tried = true;
+
+	len = lan96xx_mmc_fip_prefetch(fip_block_spec.offset, fip_block_spec.length,
+				       PLAT_LAN969X_FIP_PREFETCH_BASE,
+				       PLAT_LAN969X_FIP_PREFETCH_SIZE);
+	if (len == 0) {
+		NOTICE("FIP prefetch failed, reading in place\n");
+		return false;
+	}
+
+	fip_prefetch_spec.offset = PLAT_LAN969X_FIP_PREFETCH_BASE;
+	fip_prefetch_spec.length = len;
+
+	return true;
+}
+#endif
+
 /* Check encryption header in payload */
 static int check_enc_fip(const uintptr_t spec)
 {
@@ -689,6 +776,8 @@ bool ram_fip_valid(io_block_spec_t *spec)
 
 int bl1_plat_handle_pre_image_load(unsigned int image_id)
 {
+	boot_trace(BOOT_TRACE_IMAGE_LOAD, image_id);
+
 	/* Use RAM FIP only if defined */
 	fip_select =
 		ram_fip_valid(&ram_fip_spec) ?
@@ -702,6 +791,8 @@ int bl1_plat_handle_pre_image_load(unsigned int image_id)
 #elif defined(IMAGE_BL2)
 int bl2_plat_handle_pre_image_load(unsigned int image_id)
 {
+	boot_trace(BOOT_TRACE_IMAGE_LOAD, image_id);
+
 	/* Start with the default FIP */
 	fip_select = FIP_SELECT_DEFAULT;
 #if defined(LAN969X_LMSTAX)
@@ -786,6 +877,10 @@ static const struct plat_io_policy *current_fip_io_policy(void)
 #if defined(IMAGE_BL1)
 	if (fip_select == FIP_SELECT_RAM_FIP)
 		return &boot_source_ram_fip;
+#endif
+#if defined(FIP_PREFETCH)
+	if (fip_prefetch())
+		return &fip_prefetch_policy;
 #endif
 	return &boot_source_policies[lan966x_get_boot_source()];
 }
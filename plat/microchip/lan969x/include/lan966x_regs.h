@@ -22,6 +22,7 @@
 #define LAN966X_TRNG_BASE	LAN969X_TRNG_BASE
 #define LAN966X_GCB_BASE	LAN969X_GCB_BASE
 #define LAN966X_QSPI0_MMAP	LAN969X_QSPI0_MMAP
+#define LAN966X_QSPI0_RANGE	LAN969X_QSPI0_RANGE
 #define LAN966X_DDR_BASE	LAN969X_DDR_BASE
 #define LAN966X_DDR_ATF_SIZE	LAN969X_DDR_ATF_SIZE
 #define LAN966X_DDR_MAX_SIZE	LAN969X_DDR_MAX_SIZE
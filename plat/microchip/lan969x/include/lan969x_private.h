@@ -20,6 +20,8 @@ typedef struct {
 	uint32_t board_number;
 	size_t boot_offset;
 	uint32_t bl2_version;
+	uintptr_t boot_trace;
+	uintptr_t otp_tags;
 } bl31_params_t;
 
 void lan969x_set_max_trace_level(void);
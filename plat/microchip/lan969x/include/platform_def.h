@@ -38,6 +38,8 @@
 #define MAX_IO_HANDLES			5
 /* eMMC RPMB and eMMC User Data */
 #define MAX_IO_BLOCK_DEVICES		U(2)
+/* FIP ToC entries indexed by io_fip */
+#define FIP_TOC_INDEX_ENTRIES		U(24)
 /* QSPI NOR */
 #define MAX_IO_MTD_DEVICES		U(1)
 
@@ -99,6 +101,25 @@
 #define PLAT_LAN969X_NS_IMAGE_BASE	LAN969X_DDR_BASE
 #define PLAT_LAN969X_NS_IMAGE_SIZE	LAN969X_DDR_ATF_SIZE
 #define PLAT_LAN969X_NS_IMAGE_LIMIT	(PLAT_LAN969X_NS_IMAGE_BASE + PLAT_LAN969X_NS_IMAGE_SIZE)
+/* Where BL2 loads images. With deferred ECC init, DDR above is filled meanwhile */
+#if MCHP_DDR_ECC_DEFERRED_INIT
+#define PLAT_LAN969X_NS_LOAD_SIZE	SIZE_M(MCHP_DDR_ECC_INIT_MB)
+#else
+#define PLAT_LAN969X_NS_LOAD_SIZE	PLAT_LAN969X_NS_IMAGE_SIZE
+#endif
+#define PLAT_LAN969X_NS_LOAD_LIMIT	(PLAT_LAN969X_NS_IMAGE_BASE + PLAT_LAN969X_NS_LOAD_SIZE)
+/* BL2 scratch for a prefetched FIP, top of the load area */
+#define PLAT_LAN969X_FIP_PREFETCH_SIZE	SIZE_M(16)
+#define PLAT_LAN969X_FIP_PREFETCH_BASE	(PLAT_LAN969X_NS_LOAD_LIMIT - PLAT_LAN969X_FIP_PREFETCH_SIZE)
+#endif
+
+/* BL33 is loaded below the prefetch scratch, so it can't overlap the FIP */
+#if MCHP_FIP_PREFETCH && defined(PLAT_LAN969X_FIP_PREFETCH_BASE)
+#define PLAT_LAN969X_BL33_MAX_SIZE	(PLAT_LAN969X_FIP_PREFETCH_BASE - PLAT_LAN969X_NS_IMAGE_BASE)
+#elif defined(PLAT_LAN969X_NS_LOAD_SIZE)
+#define PLAT_LAN969X_BL33_MAX_SIZE	PLAT_LAN969X_NS_LOAD_SIZE
+#else
+#define PLAT_LAN969X_BL33_MAX_SIZE	PLAT_LAN969X_NS_IMAGE_SIZE
 #endif
 
 /*
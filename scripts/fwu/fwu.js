@@ -22,12 +22,14 @@ const CMD_BL2U_RESET ='e';
 const CMD_BL2U_DDR_CFG_SET = 'C';
 const CMD_BL2U_DDR_CFG_GET = 'c';
 const CMD_BL2U_DDR_TEST = 'T';
+const CMD_BL2U_DDR_BENCH = 'M';
 const CMD_BL2U_DATA_HASH = 'H';
 const CMD_BL2U_REG_READ = 'x';
 const CMD_BL2U_DDR_INIT = 'd';
 const CMD_BL2U_SRAM_INFO = 's';
 const CMD_BL2U_SEND_SRAM = 'J';
 const CMD_BL2U_WRITE_READBACK = 'j';
+const CMD_WINDOW = 'w';
 
 let cur_stage = "connect";	// Initial "tab"
 let tracing = false;
@@ -401,6 +403,64 @@ function updateProgress(pct)
     text.innerHTML = pct;
 }
 
+async function readResponse()
+{
+    var response = await port_reader.read();
+    return parseResponse(response.value);
+}
+
+function dataSlice(appdata, offset, length)
+{
+    if (appdata instanceof Uint8Array)
+	return appdata.slice(offset, offset + length);
+    return appdata.substr(offset, length);
+}
+
+// Returns the number of DATA frames per window, 0 if unsupported
+async function negotiateWindow(port, frameSize)
+{
+    try {
+	let rsp = await completeRequest(port, fmtReq(CMD_WINDOW, frameSize));
+	return rsp["arg"];
+    } catch (e) {
+	// Older firmware, stop-and-wait only
+	return 0;
+    }
+}
+
+async function downloadWindowed(port, appdata, binary, frames, frameSize)
+{
+    let base = 0;
+
+    while (base < appdata.length) {
+	const winLen = Math.min(appdata.length - base, frames * frameSize);
+	const nFrames = Math.ceil(winLen / frameSize);
+	let missing = (2 ** nFrames) - 1;
+
+	while (missing) {
+	    // Send all outstanding frames, then wait for a single response
+	    for (var i = 0; i < nFrames; i++) {
+		if (missing & (1 << i)) {
+		    const offset = base + (i * frameSize);
+		    const chunk = dataSlice(appdata, offset, Math.min(frameSize, base + winLen - offset));
+		    await sendRequest(port, fmtReq(CMD_DATA, offset, chunk, binary));
+		}
+	    }
+	    const rsp = await readResponse();
+	    if (rsp["command"] == CMD_ACK) {
+		base = rsp["arg"];
+		missing = 0;
+	    } else if (rsp["command"] == CMD_NACK && rsp["length"] == 0) {
+		missing = rsp["arg"];
+		console.log("Window @ %d: Retransmit mask %s", base, fmtHex(missing));
+	    } else {
+		throw rsp["data"] ? rsp["data"] : "Unspecific NACK";
+	    }
+	}
+	updateProgress((base * 100 / appdata.length).toFixed());
+    }
+}
+
 async function downloadApp(port, cmd, appdata, binary)
 {
     var completed = true;
@@ -408,17 +468,21 @@ async function downloadApp(port, cmd, appdata, binary)
     var msec_start = new Date().getTime();
     try {
 	const chunkSize = 256;
+	const windowFrameSize = 1024;
 	let bytesSent = 0;
 
+	const frames = await negotiateWindow(port, windowFrameSize);
+
 	await completeRequest(port, fmtReq(cmd, appdata.length));
 
+	if (frames > 0) {
+	    await downloadWindowed(port, appdata, binary, frames, windowFrameSize);
+	    bytesSent = appdata.length;
+	}
+
 	// Send data chunks
 	while (bytesSent < appdata.length) {
-	    let chunk;
-	    if (appdata instanceof Uint8Array)
-		chunk = appdata.slice(bytesSent, bytesSent + chunkSize);
-	    else
-		chunk = appdata.substr(bytesSent, chunkSize);
+	    let chunk = dataSlice(appdata, bytesSent, chunkSize);
 	    //console.log("Sending at offset: %d, len %d", bytesSent, chunk.length);
 	    await completeRequest(port, fmtReq(CMD_DATA, bytesSent, chunk, binary));
 	    bytesSent += chunk.length;
@@ -1301,6 +1365,69 @@ const formatDuration = ms => {
     .join(', ');
 };
 
+// Decode struct ddr_bench, report MB/s and ns per load
+function showDDRBench(data)
+{
+    const fields = ["cntfrq", "size", "loads",
+		    "nc_read", "nc_write", "nc_copy", "nc_latency",
+		    "c_read", "c_write", "c_copy", "c_latency",
+		    "dma_write", "dma_copy"];
+    let r = {};
+    fields.forEach((f, i) => r[f] = extractUint32(data, i * 4));
+
+    const mbps = (ticks) => ticks ? (r.size / (ticks / r.cntfrq) / 1e6).toFixed(1) + " MB/s" : "-";
+    const nsec = (ticks) => r.loads ? (ticks / r.cntfrq / r.loads * 1e9).toFixed(1) + " ns" : "-";
+
+    addTrace("DDR benchmark, " + (r.size >>> 20) + " MiB per pass, timer " + r.cntfrq + " Hz");
+    for (const [name, p] of [["Cache off", "nc_"], ["Cache on", "c_"]]) {
+	addTrace(" " + name + ": read " + mbps(r[p + "read"]) +
+		 ", write " + mbps(r[p + "write"]) +
+		 ", copy " + mbps(r[p + "copy"]) +
+		 ", latency " + nsec(r[p + "latency"]) +
+		 " (ticks " + r[p + "read"] + "/" + r[p + "write"] + "/" +
+		 r[p + "copy"] + "/" + r[p + "latency"] + ")");
+    }
+    addTrace(" XDMAC: write " + mbps(r.dma_write) + ", copy " + mbps(r.dma_copy) +
+	     " (ticks " + r.dma_write + "/" + r.dma_copy + ")");
+}
+
+// DMA DDR tests, in DDR_TEST_DMA_* bit order
+const ddr_test_dma = [
+    ["ddr_test_dma_rnd", "Random"],
+    ["ddr_test_dma_walk1", "Walking ones"],
+    ["ddr_test_dma_checker", "Checkerboard"],
+    ["ddr_test_dma_march", "March C-"],
+];
+const DDR_TEST_REGIONS = 8;
+
+// DMA test selection, for BOOTSTRAP_DDR_TEST arg0 bits 15:8
+function getDDRTestMask()
+{
+    let mask = 0;
+    ddr_test_dma.forEach(([id, name], i) => {
+	if (document.getElementById(id).checked)
+	    mask |= (1 << i);
+    });
+    return mask;
+}
+
+// Decode struct ddr_test_result, report time per region
+function showDDRTest(data, mask)
+{
+    const region_size = extractUint32(data, 0);
+
+    ddr_test_dma.forEach(([id, name], i) => {
+	if ((mask & (1 << i)) == 0)
+	    return;
+	let ms = [];
+	// Regions past the end of DDR read as zero
+	for (let j = 0; j < DDR_TEST_REGIONS; j++)
+	    ms.push(extractUint32(data, 4 + (i * DDR_TEST_REGIONS + j) * 4));
+	addTrace("DDR " + name + " test, " + (region_size >>> 20) + " MiB per region: " +
+		 ms.join("/") + " ms, total " + ms.reduce((a, b) => a + b, 0) + " ms");
+    });
+}
+
 function reportDuration(what, start, end)
 {
     const msec = end - start;
@@ -1520,10 +1647,16 @@ function startSerial()
 	    setActive(true);
 	    setStatus("DDR test starting");
 	    var msec_start = new Date().getTime();
-	    var arg = document.getElementById("enable_cache").checked ? 1 : 0;
+	    var mask = getDDRTestMask();
+	    var arg = (document.getElementById("enable_cache").checked ? 1 : 0) | (mask << 8);
 	    var rspStruct = await completeRequest(port, fmtReq(CMD_BL2U_DDR_TEST, arg));
 	    reportDuration("DDR test duration", msec_start, new Date().getTime());
-	    setStatus("DDR was tested: " + rspStruct["data"]);
+	    if (mask) {
+		showDDRTest(rspStruct["data"], mask);
+		setStatus("DDR was tested: Test succeeded");
+	    } else {
+		setStatus("DDR was tested: " + rspStruct["data"]);
+	    }
 	} catch(e) {
 	    setStatus("DDR test error: " + e);
 	} finally {
@@ -1532,6 +1665,22 @@ function startSerial()
 	}
     });
 
+    document.getElementById('bl2u_ddr_bench').addEventListener('click', async () => {
+	let s = disableButtons("bl2u_ddr", true);
+	try {
+	    setActive(true);
+	    setStatus("DDR benchmark starting");
+	    var rspStruct = await completeRequest(port, fmtReq(CMD_BL2U_DDR_BENCH, 0));
+	    showDDRBench(rspStruct["data"]);
+	    setStatus("DDR benchmark done");
+	} catch(e) {
+	    setStatus("DDR benchmark error: " + e);
+	} finally {
+	    setActive(false);
+	    restoreButtons(s);
+	}
+    });
+
     document.getElementById('bl2u_ddr_read_regs').addEventListener('click', async () => {
 	let s = disableButtons("bl2u_ddr", true);
 	try {
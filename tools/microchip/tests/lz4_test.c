@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of the LZ4 decoder. Reference vectors made by the lz4 tool
+ * must decode to the known text, hand made blocks cover literal-only
+ * and overlapping matches, and truncated or corrupt input must fail
+ * without writing past the output buffer.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Firmware environment stand-ins */
+#define DEBUG_H
+#define ERROR(...)	do { } while (0)
+#define VERBOSE(...)	do { } while (0)
+
+#include "../../../lib/lz4/tf_lz4.c"
+
+#define PLAIN_LEN	1500
+#define OUT_SIZE	2048
+#define GUARD		0xa5
+#define ITERATIONS	20000
+
+/*
+ * 'lz4 --content-size -BX -BD -B512' and 'lz4 -l' of the text made by
+ * make_plain(). Dependent blocks with block and content checksums.
+ */
+static const uint8_t vec_frame[] = {
+	0x04, 0x22, 0x4d, 0x18, 0x5c, 0x40, 0xdc, 0x05, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x02, 0x0a, 0x01, 0x00, 0x00, 0xf4, 0x01, 0x4c, 0x41, 0x4e,
+	0x39, 0x36, 0x39, 0x78, 0x20, 0x31, 0x20, 0x32, 0x20, 0x33, 0x20, 0x34,
+	0x20, 0x10, 0x00, 0x75, 0x36, 0x20, 0x37, 0x20, 0x38, 0x20, 0x39, 0x10,
+	0x00, 0xa6, 0x31, 0x31, 0x20, 0x31, 0x32, 0x20, 0x31, 0x33, 0x20, 0x31,
+	0x24, 0x00, 0xa6, 0x31, 0x36, 0x20, 0x31, 0x37, 0x20, 0x31, 0x38, 0x20,
+	0x31, 0x28, 0x00, 0xa6, 0x32, 0x31, 0x20, 0x32, 0x32, 0x20, 0x32, 0x33,
+	0x20, 0x32, 0x28, 0x00, 0xa6, 0x32, 0x36, 0x20, 0x32, 0x37, 0x20, 0x32,
+	0x38, 0x20, 0x32, 0x28, 0x00, 0xa6, 0x33, 0x31, 0x20, 0x33, 0x32, 0x20,
+	0x33, 0x33, 0x20, 0x33, 0x28, 0x00, 0x41, 0x33, 0x36, 0x20, 0x30, 0x89,
+	0x00, 0x04, 0x85, 0x00, 0x75, 0x34, 0x20, 0x35, 0x20, 0x36, 0x20, 0x37,
+	0x85, 0x00, 0x43, 0x39, 0x20, 0x31, 0x30, 0x8a, 0x00, 0x04, 0x23, 0x00,
+	0x53, 0x31, 0x34, 0x20, 0x31, 0x35, 0x8a, 0x00, 0x05, 0x14, 0x00, 0x43,
+	0x39, 0x20, 0x32, 0x30, 0x8a, 0x00, 0x04, 0x14, 0x00, 0x53, 0x32, 0x34,
+	0x20, 0x32, 0x35, 0x8a, 0x00, 0x05, 0x14, 0x00, 0x43, 0x39, 0x20, 0x33,
+	0x30, 0x8a, 0x00, 0x04, 0x14, 0x00, 0x52, 0x33, 0x34, 0x20, 0x33, 0x35,
+	0x8a, 0x00, 0x04, 0x13, 0x00, 0x02, 0x19, 0x01, 0x15, 0x35, 0x86, 0x00,
+	0x02, 0x19, 0x01, 0x16, 0x31, 0x21, 0x00, 0x05, 0x19, 0x01, 0x16, 0x31,
+	0x25, 0x00, 0x05, 0x19, 0x01, 0x16, 0x32, 0x28, 0x00, 0x05, 0x19, 0x01,
+	0x16, 0x32, 0x28, 0x00, 0x05, 0x19, 0x01, 0x16, 0x33, 0x28, 0x00, 0x05,
+	0x19, 0x01, 0x16, 0x33, 0x28, 0x00, 0x02, 0x19, 0x01, 0x15, 0x33, 0x85,
+	0x00, 0x02, 0x19, 0x01, 0x15, 0x38, 0x10, 0x00, 0x05, 0x19, 0x01, 0x16,
+	0x31, 0x24, 0x00, 0x05, 0x19, 0x01, 0x16, 0x31, 0x28, 0x00, 0x05, 0x19,
+	0x01, 0x70, 0x32, 0x33, 0x20, 0x4c, 0x41, 0x4e, 0x39, 0xf5, 0x99, 0xb9,
+	0x7c, 0x5e, 0x00, 0x00, 0x00, 0x36, 0x36, 0x39, 0x78, 0x19, 0x01, 0x16,
+	0x32, 0x28, 0x00, 0x05, 0x19, 0x01, 0x16, 0x33, 0x50, 0x00, 0x04, 0x19,
+	0x01, 0x15, 0x31, 0x76, 0x00, 0x13, 0x33, 0xa3, 0x01, 0x04, 0x2b, 0x01,
+	0x15, 0x38, 0xa3, 0x01, 0x04, 0x12, 0x00, 0x02, 0x32, 0x02, 0x02, 0x8a,
+	0x00, 0x05, 0x14, 0x00, 0x01, 0x32, 0x02, 0x02, 0x8a, 0x00, 0x04, 0x14,
+	0x00, 0x02, 0x32, 0x02, 0x02, 0xa3, 0x01, 0x05, 0x14, 0x00, 0x01, 0x32,
+	0x02, 0x02, 0x8a, 0x00, 0x04, 0x14, 0x00, 0x02, 0x32, 0x02, 0x02, 0x8a,
+	0x00, 0x04, 0x14, 0x00, 0x0f, 0xbc, 0x02, 0xff, 0x25, 0x50, 0x39, 0x36,
+	0x39, 0x78, 0x20, 0xd2, 0xbe, 0x55, 0x34, 0x74, 0x00, 0x00, 0x00, 0x26,
+	0x31, 0x32, 0xa3, 0x01, 0x05, 0x50, 0x01, 0x16, 0x37, 0xa3, 0x01, 0x04,
+	0x14, 0x00, 0x26, 0x32, 0x32, 0xa3, 0x01, 0x05, 0x14, 0x00, 0x01, 0x32,
+	0x02, 0x02, 0xa3, 0x01, 0x04, 0x14, 0x00, 0x02, 0x32, 0x02, 0x02, 0xa3,
+	0x01, 0x04, 0x14, 0x00, 0x13, 0x30, 0xa2, 0x01, 0x04, 0x10, 0x00, 0x66,
+	0x35, 0x20, 0x36, 0x20, 0x37, 0x20, 0x6c, 0x02, 0x62, 0x31, 0x30, 0x20,
+	0x31, 0x31, 0x20, 0x8a, 0x00, 0x04, 0x24, 0x00, 0x02, 0x32, 0x02, 0x02,
+	0x8a, 0x00, 0x04, 0x14, 0x00, 0x02, 0x32, 0x02, 0x02, 0x8a, 0x00, 0x05,
+	0x14, 0x00, 0x43, 0x35, 0x20, 0x32, 0x36, 0x8a, 0x00, 0x04, 0x14, 0x00,
+	0x02, 0x32, 0x02, 0x02, 0x8a, 0x00, 0x05, 0x14, 0x00, 0x0f, 0xbc, 0x02,
+	0xdb, 0x50, 0x39, 0x36, 0x39, 0x78, 0x20, 0x1a, 0x39, 0x59, 0x66, 0x00,
+	0x00, 0x00, 0x00, 0x9a, 0x65, 0x7a, 0x0e,
+};
+
+static const uint8_t vec_legacy[] = {
+	0x02, 0x21, 0x4c, 0x18, 0x66, 0x01, 0x00, 0x00, 0xf4, 0x01, 0x4c, 0x41,
+	0x4e, 0x39, 0x36, 0x39, 0x78, 0x20, 0x31, 0x20, 0x32, 0x20, 0x33, 0x20,
+	0x34, 0x20, 0x10, 0x00, 0x75, 0x36, 0x20, 0x37, 0x20, 0x38, 0x20, 0x39,
+	0x10, 0x00, 0xa6, 0x31, 0x31, 0x20, 0x31, 0x32, 0x20, 0x31, 0x33, 0x20,
+	0x31, 0x24, 0x00, 0xa6, 0x31, 0x36, 0x20, 0x31, 0x37, 0x20, 0x31, 0x38,
+	0x20, 0x31, 0x28, 0x00, 0xa6, 0x32, 0x31, 0x20, 0x32, 0x32, 0x20, 0x32,
+	0x33, 0x20, 0x32, 0x28, 0x00, 0xa6, 0x32, 0x36, 0x20, 0x32, 0x37, 0x20,
+	0x32, 0x38, 0x20, 0x32, 0x28, 0x00, 0xa6, 0x33, 0x31, 0x20, 0x33, 0x32,
+	0x20, 0x33, 0x33, 0x20, 0x33, 0x28, 0x00, 0x41, 0x33, 0x36, 0x20, 0x30,
+	0x89, 0x00, 0x04, 0x85, 0x00, 0x31, 0x34, 0x20, 0x35, 0x89, 0x00, 0x04,
+	0x10, 0x00, 0x43, 0x39, 0x20, 0x31, 0x30, 0x8a, 0x00, 0x04, 0x13, 0x00,
+	0x53, 0x31, 0x34, 0x20, 0x31, 0x35, 0x8a, 0x00, 0x05, 0x14, 0x00, 0x43,
+	0x39, 0x20, 0x32, 0x30, 0x8a, 0x00, 0x04, 0x14, 0x00, 0x53, 0x32, 0x34,
+	0x20, 0x32, 0x35, 0x8a, 0x00, 0x05, 0x14, 0x00, 0x43, 0x39, 0x20, 0x33,
+	0x30, 0x8a, 0x00, 0x04, 0x14, 0x00, 0x52, 0x33, 0x34, 0x20, 0x33, 0x35,
+	0x8a, 0x00, 0x04, 0x13, 0x00, 0x02, 0x19, 0x01, 0x15, 0x35, 0x0b, 0x01,
+	0x02, 0x19, 0x01, 0x16, 0x31, 0x21, 0x00, 0x05, 0x19, 0x01, 0x16, 0x31,
+	0x25, 0x00, 0x05, 0x19, 0x01, 0x16, 0x32, 0x28, 0x00, 0x05, 0x19, 0x01,
+	0x16, 0x32, 0x28, 0x00, 0x05, 0x19, 0x01, 0x16, 0x33, 0x28, 0x00, 0x05,
+	0x19, 0x01, 0x16, 0x33, 0x28, 0x00, 0x02, 0x19, 0x01, 0x15, 0x33, 0x85,
+	0x00, 0x02, 0x19, 0x01, 0x15, 0x38, 0x10, 0x00, 0x05, 0x19, 0x01, 0x16,
+	0x31, 0x24, 0x00, 0x05, 0x19, 0x01, 0x16, 0x31, 0x28, 0x00, 0x05, 0x19,
+	0x01, 0x16, 0x32, 0x28, 0x00, 0x05, 0x19, 0x01, 0x16, 0x32, 0x28, 0x00,
+	0x05, 0x19, 0x01, 0x16, 0x33, 0x28, 0x00, 0x04, 0x19, 0x01, 0x15, 0x31,
+	0x76, 0x00, 0x00, 0x32, 0x02, 0x00, 0x8a, 0x00, 0x04, 0x2b, 0x01, 0x00,
+	0x32, 0x02, 0x02, 0x8a, 0x00, 0x04, 0x12, 0x00, 0x02, 0x32, 0x02, 0x02,
+	0x8a, 0x00, 0x05, 0x14, 0x00, 0x01, 0x32, 0x02, 0x02, 0x8a, 0x00, 0x04,
+	0x14, 0x00, 0x02, 0x32, 0x02, 0x02, 0x8a, 0x00, 0x05, 0x14, 0x00, 0x01,
+	0x32, 0x02, 0x02, 0x8a, 0x00, 0x04, 0x14, 0x00, 0x02, 0x32, 0x02, 0x02,
+	0x8a, 0x00, 0x04, 0x14, 0x00, 0x0f, 0xbc, 0x02, 0xff, 0xff, 0xff, 0x03,
+	0x50, 0x39, 0x36, 0x39, 0x78, 0x20,
+};
+
+struct block_vec {
+	const char *name;
+	const uint8_t *in;
+	size_t in_len;
+	const char *out;	/* NULL if decoding must fail */
+};
+
+#define LEGACY_HDR(n)	0x02, 0x21, 0x4c, 0x18, (n), 0x00, 0x00, 0x00
+
+/* Literals only, one of them with an extended length */
+static const uint8_t lit_only[] = {
+	LEGACY_HDR(6), 0x50, 'h', 'e', 'l', 'l', 'o',
+};
+static const uint8_t lit_long[] = {
+	LEGACY_HDR(22), 0xf0, 0x05,
+	'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
+	'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't',
+};
+
+/* Frame with one stored (uncompressed) block */
+static const uint8_t lit_stored[] = {
+	0x04, 0x22, 0x4d, 0x18, 0x60, 0x40, 0x00,
+	0x03, 0x00, 0x00, 0x80, 'a', 'b', 'c',
+	0x00, 0x00, 0x00, 0x00,
+};
+
+/* Matches overlapping their own output, offsets 1, 3 and 7 */
+static const uint8_t overlap_1[] = {
+	LEGACY_HDR(6), 0x16, 'a', 0x01, 0x00, 0x10, 'z',
+};
+static const uint8_t overlap_3[] = {
+	LEGACY_HDR(9), 0x3f, 'a', 'b', 'c', 0x03, 0x00, 0x02, 0x10, '!',
+};
+static const uint8_t overlap_7[] = {
+	LEGACY_HDR(12), 0x7c, '1', '2', '3', '4', '5', '6', '7', 0x07, 0x00,
+	0x10, '.',
+};
+
+/* Corrupt blocks */
+static const uint8_t bad_offset[] = {
+	LEGACY_HDR(4), 0x10, 'a', 0x05, 0x00,
+};
+static const uint8_t bad_offset_0[] = {
+	LEGACY_HDR(4), 0x10, 'a', 0x00, 0x00,
+};
+static const uint8_t bad_literals[] = {
+	LEGACY_HDR(3), 0x50, 'a', 'b',
+};
+static const uint8_t bad_ext_len[] = {
+	LEGACY_HDR(3), 0xf0, 0xff, 0xff,
+};
+static const uint8_t bad_match_tail[] = {
+	LEGACY_HDR(3), 0x10, 'a', 0x01,
+};
+static const uint8_t bad_block_size[] = {
+	LEGACY_HDR(0x40), 0x10, 'a', 0x01, 0x00,
+};
+static const uint8_t bad_frame_flags[] = {
+	0x04, 0x22, 0x4d, 0x18, 0xa0, 0x40, 0x00,
+	0x00, 0x00, 0x00, 0x00,
+};
+
+#define VEC(v, o)	{ #v, v, sizeof(v), o }
+
+static const struct block_vec block_vecs[] = {
+	VEC(lit_only, "hello"),
+	VEC(lit_long, "abcdefghijklmnopqrst"),
+	VEC(lit_stored, "abc"),
+	VEC(overlap_1, "aaaaaaaaaaaz"),
+	VEC(overlap_3, "abcabcabcabcabcabcabcabc!"),
+	VEC(overlap_7, "12345671234567123456712."),
+	VEC(bad_offset, NULL),
+	VEC(bad_offset_0, NULL),
+	VEC(bad_literals, NULL),
+	VEC(bad_ext_len, NULL),
+	VEC(bad_match_tail, NULL),
+	VEC(bad_block_size, NULL),
+	VEC(bad_frame_flags, NULL),
+};
+
+static uint8_t plain[PLAIN_LEN];
+static uint8_t out[OUT_SIZE];
+
+/* Deterministic, so failures can be reproduced */
+static uint32_t rnd_state = 0x12345678;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+static void make_plain(void)
+{
+	char word[16];
+	size_t pos = 0, len;
+	int i;
+
+	for (i = 0; pos < PLAIN_LEN; i++) {
+		if (i % 5)
+			snprintf(word, sizeof(word), "%d ", i % 37);
+		else
+			snprintf(word, sizeof(word), "LAN969x ");
+		len = strlen(word);
+		if (len > PLAIN_LEN - pos)
+			len = PLAIN_LEN - pos;
+		memcpy(plain + pos, word, len);
+		pos += len;
+	}
+}
+
+/* Decode into 'out', limited to 'out_len'. Checks the guard after it */
+static int decode(const uint8_t *in, size_t in_len, size_t out_len,
+		  size_t *len, const uint8_t **in_end)
+{
+	uintptr_t ip = (uintptr_t) in, op = (uintptr_t) out;
+	size_t i;
+	int ret;
+
+	memset(out, GUARD, sizeof(out));
+	ret = unlz4(&ip, in_len, &op, out_len);
+	*len = op - (uintptr_t) out;
+	if (in_end != NULL)
+		*in_end = (const uint8_t *) ip;
+
+	for (i = out_len; i < sizeof(out); i++) {
+		if (out[i] != GUARD) {
+			printf("FAIL: output overrun at %zu of %zu\n", i, out_len);
+			return -EFAULT;
+		}
+	}
+
+	return ret;
+}
+
+static int check_ref(const char *name, const uint8_t *in, size_t in_len)
+{
+	const uint8_t *in_end;
+	size_t len, size;
+	int fail = 0, ret;
+
+	ret = unlz4_size((uintptr_t) in, in_len, &size);
+	if (ret != 0 || size != PLAIN_LEN) {
+		printf("FAIL: %s: size %d, %zu\n", name, ret, size);
+		fail++;
+	}
+
+	ret = decode(in, in_len, PLAIN_LEN, &len, &in_end);
+	if (ret != 0 || len != PLAIN_LEN || memcmp(out, plain, PLAIN_LEN) != 0) {
+		printf("FAIL: %s: decode %d, %zu bytes\n", name, ret, len);
+		fail++;
+	}
+	if (in_end != in + in_len) {
+		printf("FAIL: %s: input end %td of %zu\n", name, in_end - in, in_len);
+		fail++;
+	}
+
+	/* One byte short of room */
+	ret = decode(in, in_len, PLAIN_LEN - 1, &len, NULL);
+	if (ret != -ENOSPC) {
+		printf("FAIL: %s: short output %d\n", name, ret);
+		fail++;
+	}
+
+	return fail;
+}
+
+/* Every cut into the data must fail, and never write out of bounds */
+static int check_truncated(const char *name, const uint8_t *in, size_t in_len,
+			   size_t min_len)
+{
+	size_t cut, len, size;
+	int fail = 0, ret;
+
+	for (cut = min_len; cut < in_len; cut++) {
+		ret = unlz4_size((uintptr_t) in, cut, &size);
+		if (ret == 0) {
+			printf("FAIL: %s: size of %zu byte cut passed\n", name, cut);
+			fail++;
+		}
+		ret = decode(in, cut, PLAIN_LEN, &len, NULL);
+		if (ret == 0 || ret == -EFAULT) {
+			printf("FAIL: %s: decode of %zu byte cut: %d\n", name, cut, ret);
+			fail++;
+		}
+	}
+
+	return fail;
+}
+
+/* Random corruption must stay in bounds, and agree with the size walk */
+static int check_corrupt(const char *name, const uint8_t *ref, size_t in_len)
+{
+	uint8_t in[1024];
+	size_t len, size, i;
+	int fail = 0, ret, n;
+
+	for (n = 0; n < ITERATIONS; n++) {
+		memcpy(in, ref, in_len);
+		for (i = rnd() % 4; i < 4; i++)
+			in[4 + rnd() % (in_len - 4)] = rnd();
+
+		ret = decode(in, in_len, PLAIN_LEN, &len, NULL);
+		if (ret == -EFAULT) {
+			fail++;
+			continue;
+		}
+
+		if (unlz4_size((uintptr_t) in, in_len, &size) == 0 && size <= PLAIN_LEN &&
+		    (ret != 0 || len != size)) {
+			printf("FAIL: %s: size %zu, decode %d, %zu bytes\n",
+			       name, size, ret, len);
+			fail++;
+		}
+	}
+
+	return fail;
+}
+
+int main(void)
+{
+	const struct block_vec *v;
+	size_t len, i;
+	int fail = 0, ret;
+
+	make_plain();
+
+	for (i = 0; i < sizeof(block_vecs) / sizeof(block_vecs[0]); i++) {
+		v = &block_vecs[i];
+		ret = decode(v->in, v->in_len, OUT_SIZE / 2, &len, NULL);
+		if (v->out == NULL) {
+			if (ret == 0 || ret == -EFAULT) {
+				printf("FAIL: %s: decoded %d, %zu bytes\n", v->name, ret, len);
+				fail++;
+			}
+		} else if (ret != 0 || len != strlen(v->out) ||
+			   memcmp(out, v->out, len) != 0) {
+			printf("FAIL: %s: %d, '%.*s'\n", v->name, ret, (int) len, out);
+			fail++;
+		}
+	}
+
+	fail += check_ref("frame", vec_frame, sizeof(vec_frame));
+	fail += check_ref("legacy", vec_legacy, sizeof(vec_legacy));
+
+	/* A legacy stream has no end mark, only cut into its block */
+	fail += check_truncated("frame", vec_frame, sizeof(vec_frame), 0);
+	fail += check_truncated("legacy", vec_legacy, sizeof(vec_legacy), 9);
+
+	fail += check_corrupt("frame", vec_frame, sizeof(vec_frame));
+	fail += check_corrupt("legacy", vec_legacy, sizeof(vec_legacy));
+
+	printf("lz4: %s\n", fail ? "FAILED" : "passed");
+
+	return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}